@@ -0,0 +1,81 @@
+/**
+ * @file hud_glyphs.h
+ * @brief Right-aligned numeric HUD text with per-glyph change tracking, no
+ * dependencies.
+ *
+ * This header is standalone/test-friendly and designed for use in both
+ * host-side unit tests and embedded game builds. It only decides which
+ * characters a number needs and which of them changed; drawing is up to the
+ * caller (see ti_number_hud.h).
+ */
+
+#ifndef HUD_GLYPHS_H
+#define HUD_GLYPHS_H
+
+namespace ti {
+/**
+ * Glyphs for "<prefix><value>", stored right to left: slot 0 is the ones
+ * digit, the prefix follows the most significant digit and unused slots hold
+ * a space.
+ *
+ * @tparam Slots Maximum characters, prefix included
+ */
+template <int Slots>
+class HudGlyphs {
+  static_assert(Slots >= 2 && Slots <= 32, "Slots must fit the change mask.");
+
+ public:
+  explicit constexpr HudGlyphs(char prefix) : _prefix(prefix) {}
+
+  /**
+   * Updates the glyphs for a new value.
+   *
+   * @param value Non-negative number to show (negatives show as 0)
+   * @return Bit mask of slots whose glyph changed; 0 when nothing to redraw
+   */
+  constexpr unsigned set_value(int value) {
+    if (_valid && value == _value) {
+      return 0;
+    }
+
+    char next[Slots] = {};
+    unsigned remaining = value < 0 ? 0 : unsigned(value);
+    int length = 0;
+    do {
+      next[length++] = char('0' + remaining % 10);
+      remaining /= 10;
+    } while (remaining > 0 && length < Slots - 1);
+    next[length++] = _prefix;
+    for (int slot = length; slot < Slots; ++slot) {
+      next[slot] = ' ';
+    }
+
+    unsigned changed = 0;
+    for (int slot = 0; slot < Slots; ++slot) {
+      if (!_valid || next[slot] != _glyphs[slot]) {
+        changed |= 1u << slot;
+        _glyphs[slot] = next[slot];
+      }
+    }
+    _value = value;
+    _length = length;
+    _valid = true;
+    return changed;
+  }
+
+  /** @return Glyph at a slot (0 = rightmost), ' ' when unused */
+  [[nodiscard]] constexpr char glyph(int slot) const { return _glyphs[slot]; }
+
+  /** @return Number of slots in use, prefix included */
+  [[nodiscard]] constexpr int length() const { return _length; }
+
+ private:
+  char _glyphs[Slots] = {};
+  char _prefix;
+  int _value = 0;
+  int _length = 0;
+  bool _valid = false;
+};
+}  // namespace ti
+
+#endif  // HUD_GLYPHS_H
@@ -0,0 +1,95 @@
+/**
+ * @file ti_anim_clips.h
+ * @brief Compile-time animation clips for customer sprite sheets and a
+ * stateless-per-frame player, no dependencies.
+ *
+ * CLIP: Enum naming each clip in CUSTOMER_CLIPS.
+ * ClipPlayer: Remembers which clip an entity plays and the tick it started;
+ * the current sheet frame is derived from a global tick, so no per-entity
+ * bn::sprite_animate_action has to be built or updated.
+ *
+ * This header is standalone/test-friendly and designed for use in both
+ * host-side unit tests and embedded game builds.
+ */
+#ifndef TI_ANIM_CLIPS_H
+#define TI_ANIM_CLIPS_H
+
+namespace ti {
+
+/**
+ * @brief Animation clips a customer can request from its view.
+ */
+enum class CLIP : unsigned char {
+  WALK,           // frames 0-7
+  WALK_W_COFFEE,  // frames 8-15
+  IDLE,           // frames 16/17
+};
+
+/**
+ * @brief A looping run of sheet frames, each shown for "period" ticks.
+ *
+ * period matches bn::sprite_animate_action timing: wait_updates + 1.
+ */
+struct AnimClip {
+  int period;
+  int frame_count;
+  unsigned char frames[8];
+};
+
+/**
+ * @brief Clips of every walk*.bmp customer sheet, indexed by CLIP.
+ */
+constexpr AnimClip CUSTOMER_CLIPS[] = {
+    {13, 8, {0, 1, 2, 3, 4, 5, 6, 7}},         // CLIP::WALK
+    {13, 8, {8, 9, 10, 11, 12, 13, 14, 15}},  // CLIP::WALK_W_COFFEE
+    {84, 2, {16, 17}},  // CLIP::IDLE: 16 x4 then 17 x4 at 21 ticks each
+};
+
+static_assert(sizeof(CUSTOMER_CLIPS) / sizeof(CUSTOMER_CLIPS[0]) == 3,
+              "Clip table must match CLIP enum.");
+
+constexpr const AnimClip& clip_data(CLIP clip) {
+  return CUSTOMER_CLIPS[static_cast<int>(clip)];
+}
+
+/**
+ * @class ClipPlayer
+ * @brief Per-entity clip state: which clip and since when.
+ *
+ * play() only restarts when the clip actually differs, so re-requesting the
+ * clip that is already playing every frame costs nothing.
+ */
+class ClipPlayer {
+ public:
+  /**
+   * @brief Switches to a clip starting at "tick", unless it already plays.
+   * @return True if the clip changed.
+   */
+  constexpr bool play(CLIP clip, int tick) {
+    if (_started && clip == _clip) {
+      return false;
+    }
+    _clip = clip;
+    _start_tick = tick;
+    _started = true;
+    return true;
+  }
+
+  /** @return Sheet frame to show at "tick" */
+  [[nodiscard]] constexpr int frame(int tick) const {
+    const AnimClip& clip = clip_data(_clip);
+    int step = ((tick - _start_tick) / clip.period) % clip.frame_count;
+    return clip.frames[step];
+  }
+
+  [[nodiscard]] constexpr CLIP clip() const { return _clip; }
+
+ private:
+  int _start_tick = 0;
+  CLIP _clip = CLIP::WALK;
+  bool _started = false;
+};
+
+}  // namespace ti
+
+#endif
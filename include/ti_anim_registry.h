@@ -0,0 +1,86 @@
+/**
+ * @file ti_anim_registry.h
+ * @brief Tracks which ambient animations play, no dependencies.
+ *
+ * An animation is playing from when it is started until its action reports
+ * done. Independently, it can be suspended while the sprite it drives is
+ * hidden (e.g. an upgrade that has not been bought yet). step() only visits
+ * animations that are playing and not suspended, so hidden decorations cost
+ * nothing per frame and pick up where they were once shown.
+ *
+ * This header is standalone/test-friendly and designed for use in both
+ * host-side unit tests and embedded game builds.
+ */
+#ifndef TI_ANIM_REGISTRY_H
+#define TI_ANIM_REGISTRY_H
+
+namespace ti {
+
+/**
+ * @class AnimRegistry
+ * @brief Playing and suspended flags of up to 32 animations, as bitmasks.
+ *
+ * @tparam MaxAnimations Animation ids are 0..MaxAnimations-1
+ */
+template <int MaxAnimations>
+class AnimRegistry {
+  static_assert(MaxAnimations > 0 && MaxAnimations <= 32,
+                "Animations must fit in one bitmask.");
+
+ public:
+  /** @brief Marks an animation as started; it plays unless suspended. */
+  constexpr void play(int id) { _playing |= _bit(id); }
+
+  /** @brief Marks an animation as done. */
+  constexpr void stop(int id) { _playing &= ~_bit(id); }
+
+  /**
+   * @brief Suspends or resumes an animation along with its sprite.
+   * @param visible Whether the sprite it drives is shown
+   */
+  constexpr void set_visible(int id, bool visible) {
+    if (visible) {
+      _suspended &= ~_bit(id);
+    } else {
+      _suspended |= _bit(id);
+    }
+  }
+
+  [[nodiscard]] constexpr bool playing(int id) const {
+    return _playing & _bit(id);
+  }
+
+  [[nodiscard]] constexpr bool suspended(int id) const {
+    return _suspended & _bit(id);
+  }
+
+  /** @return Whether step() would visit the animation */
+  [[nodiscard]] constexpr bool running(int id) const {
+    return playing(id) && !suspended(id);
+  }
+
+  /**
+   * @brief Calls animate(id) for every running animation, lowest id first.
+   * @param animate Steps one animation; returns true once it is done
+   */
+  template <typename Animate>
+  constexpr void step(Animate &&animate) {
+    for (unsigned pending = _playing & ~_suspended; pending != 0;
+         pending &= pending - 1) {
+      const int id = __builtin_ctz(pending);
+      if (animate(id)) {
+        stop(id);
+      }
+    }
+  }
+
+ private:
+  [[nodiscard]] static constexpr unsigned _bit(int id) { return 1u << id; }
+
+  unsigned _playing = 0;
+  unsigned _suspended = 0;
+};
+
+}  // namespace ti
+
+#endif
@@ -0,0 +1,42 @@
+/**
+ * @file ti_cafe_layout.h
+ * @brief Waypoints customers walk between, as one constexpr table.
+ *
+ * Positions are in Butano screen coordinates (origin at the screen centre).
+ * CAFE_LAYOUT is constant-initialized, so it lives in ROM and is shared by
+ * every customer instead of being copied into each one.
+ */
+#ifndef TI_CAFE_LAYOUT_H
+#define TI_CAFE_LAYOUT_H
+
+#include "bn_fixed_point.h"
+
+namespace ti {
+
+/**
+ * @brief Where things are in the cafe and on the street outside.
+ */
+struct CafeLayout {
+  bn::fixed_point till;           // where a new queuer first heads
+  bn::fixed_point counter1;       // pick-up spot, alternating with counter2
+  bn::fixed_point counter2;
+  bn::fixed_point door;
+  bn::fixed_point outside;        // street spot just outside the door
+  bn::fixed_point left;           // offscreen turnaround points
+  bn::fixed_point right;
+  bn::fixed_point queue_start;    // just inside, before joining the queue
+  bn::fixed_point queue_front;    // order queue slot 0, at the till
+  bn::fixed_point queue_spacing;  // offset from one queue slot to the next
+};
+
+constexpr CafeLayout CAFE_LAYOUT = {
+    bn::fixed_point(-66, 14),  bn::fixed_point(-100, 16),
+    bn::fixed_point(-86, 14),  bn::fixed_point(88, 36),
+    bn::fixed_point(100, 60),  bn::fixed_point(-140, 60),
+    bn::fixed_point(180, 60),  bn::fixed_point(0, 24),
+    bn::fixed_point(-60, 12),  bn::fixed_point(5, 3),
+};
+
+}  // namespace ti
+
+#endif
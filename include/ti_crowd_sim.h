@@ -0,0 +1,88 @@
+/**
+ * @file ti_crowd_sim.h
+ * @brief Declares CrowdSim, the render-free simulation of every customer in
+ * the cafe plus the state they share (order queue, counter spot, styles).
+ *
+ * main() drives one CrowdSim per frame and mirrors it onto sprites through
+ * ti::Person views. Host tests drive the same class directly to soak-test
+ * hours of gameplay in seconds.
+ */
+#ifndef TI_CROWD_SIM_H
+#define TI_CROWD_SIM_H
+
+#include "bn_vector.h"
+#include "ti_order_queue.h"
+#include "ti_person_sim.h"
+#include "ti_style_pool.h"
+
+namespace ti {
+
+/**
+ * @class CrowdSim
+ * @brief Owns all customer simulations and steps the active ones each frame.
+ */
+class CrowdSim {
+ public:
+  // Customers are added as popularity grows; more of them than styles just
+  // means some share a look.
+  static constexpr int MAX_PEOPLE = 32;
+  static constexpr int STYLE_COUNT = 14;
+  // Each look in play holds a palette bank. The shared sprite palettes and
+  // the text palettes leave 11; one stays free for a respawning customer's
+  // next look, which loads before the old one is let go.
+  static constexpr int MAX_LOOKS_IN_PLAY = 10;
+  // Stream of the crowd seed no customer draws from, for randomness shared
+  // by the whole cafe (ambient actors, payouts) in main().
+  static constexpr unsigned SHARED_STREAM = MAX_PEOPLE;
+
+  /**
+   * @param queue_length Customers that fit in line at the till
+   * @param seed Master seed; customer i draws from stream i of it
+   */
+  explicit CrowdSim(int queue_length = OrderQueue::DEFAULT_LENGTH,
+                    unsigned seed = Rng::DEFAULT_SEED)
+      : _order_queue(queue_length), _seed(seed) {}
+  CrowdSim(const CrowdSim &) = delete;
+  CrowdSim &operator=(const CrowdSim &) = delete;
+
+  /**
+   * @brief Adds a customer; ids are assigned in insertion order.
+   * @return The new customer's simulation state.
+   */
+  PersonSim &add_person(START start, TYPE type);
+
+  /**
+   * @brief Advances one frame for the first active_count customers.
+   * @param active_count How many customers are in play (popularity level)
+   * @return True if any customer completed a purchase this frame.
+   */
+  bool update(int active_count);
+
+  [[nodiscard]] const bn::vector<PersonSim, MAX_PEOPLE> &people() const {
+    return _people;
+  }
+
+  [[nodiscard]] const OrderQueue &order_queue() const {
+    return _order_queue;
+  }
+
+  /** @return Styles not worn by any customer in play */
+  [[nodiscard]] const StylePool &styles() const { return _styles; }
+
+  /** @return Number of update() calls so far; drives customer animations */
+  [[nodiscard]] int tick() const { return _tick; }
+
+ private:
+  bn::vector<PersonSim, MAX_PEOPLE> _people;
+  OrderQueue _order_queue;
+  StylePool _styles{STYLE_COUNT, MAX_LOOKS_IN_PLAY};
+  int _styled_count = 0;  // customers whose style is held in _styles
+  bool _waiting_spot = false;
+  int _active_loiterers = 0;  // customers loitering on the street
+  int _tick = 0;
+  unsigned _seed;
+};
+
+}  // namespace ti
+
+#endif
@@ -14,11 +14,26 @@
 #include "bn_vector.h"
 
 namespace ti {
+/**
+ * @brief Per-frame displacement of length "speed" from "from" toward "to".
+ *
+ * Integer-only: the heading comes from a precomputed unit-vector table indexed
+ * by the octant-reduced slope of the whole-pixel offset, so no atan2/sin/cos
+ * runs on the hot path. Returns (0, 0) when the offset is under one pixel.
+ * @param from Starting position
+ * @param to Target position
+ * @param speed Length of the returned vector
+ * @return Velocity to add to "from" each frame
+ */
+bn::fixed_point get_step_vector(const bn::fixed_point& from,
+                                const bn::fixed_point& to, bn::fixed speed);
+
 /**
  * @brief Move "from" toward "to" by up to "speed" units. If within 2 units,
  * snap to "to".
  *
- * Useful for simple tile/sprite chasing logic and variable speed step.
+ * Useful for simple tile/sprite chasing logic and variable speed step. The
+ * heading is taken from get_step_vector().
  * @param from Starting position
  * @param to Target position
  * @param speed Max amount to move this frame
@@ -26,6 +41,31 @@ namespace ti {
  */
 bn::fixed_point get_next_step(const bn::fixed_point& from,
                               const bn::fixed_point& to, bn::fixed speed);
+
+/**
+ * @brief Number of "step" increments after which "from" is within 2 units of
+ * "to" on both axes, i.e. where get_next_step() would snap.
+ *
+ * Lets a walker cache its velocity for a whole leg and detect arrival with a
+ * counter instead of comparing coordinates every frame.
+ * @param from Starting position
+ * @param to Target position
+ * @param step Per-frame displacement, usually from get_step_vector()
+ * @return Steps before the snap frame (0 if already within the snap range)
+ */
+int count_steps_to(const bn::fixed_point& from, const bn::fixed_point& to,
+                   const bn::fixed_point& step);
+
+/**
+ * @brief Whether a box lies entirely outside the 240x160 screen, using
+ * Butano's screen-centred sprite coordinates.
+ * @param center Centre of the box (a sprite's position)
+ * @param half_width Half the box width in pixels
+ * @param half_height Half the box height in pixels
+ * @return True if no pixel of the box is visible
+ */
+bool is_offscreen(const bn::fixed_point& center, int half_width,
+                  int half_height);
 }  // namespace ti
 
 #include "cursor_helpers.h"
@@ -0,0 +1,169 @@
+/**
+ * @file ti_input_log.h
+ * @brief Run-length keypad recording and replay, no dependencies.
+ *
+ * FrameInput: Held keys for the current frame plus the ones pressed since the
+ * previous frame; main() reads all input through it instead of bn::keypad.
+ * InputLog: RNG seed plus per-frame key masks as (keys, frames) runs.
+ * InputReplay: Feeds an InputLog back one frame at a time.
+ *
+ * Key bits match the GBA KEYINPUT register (and bn::keypad::key_type), so a
+ * log is trivially copyable to SRAM and readable by host tests alike.
+ *
+ * This header is standalone/test-friendly and designed for use in both
+ * host-side unit tests and embedded game builds.
+ */
+#ifndef TI_INPUT_LOG_H
+#define TI_INPUT_LOG_H
+
+namespace ti {
+
+/**
+ * @brief Keypad buttons as KEYINPUT bits.
+ */
+enum KEY : unsigned short {
+  KEY_A = 1 << 0,
+  KEY_B = 1 << 1,
+  KEY_SELECT = 1 << 2,
+  KEY_START = 1 << 3,
+  KEY_RIGHT = 1 << 4,
+  KEY_LEFT = 1 << 5,
+  KEY_UP = 1 << 6,
+  KEY_DOWN = 1 << 7,
+  KEY_R = 1 << 8,
+  KEY_L = 1 << 9,
+};
+
+constexpr int KEY_COUNT = 10;
+
+/**
+ * @brief Keys held this frame and keys newly pressed this frame.
+ */
+class FrameInput {
+ public:
+  constexpr void update(unsigned short keys) {
+    _pressed = keys & ~_held;
+    _held = keys;
+  }
+
+  [[nodiscard]] constexpr bool held(KEY key) const { return _held & key; }
+  [[nodiscard]] constexpr bool pressed(KEY key) const { return _pressed & key; }
+  [[nodiscard]] constexpr unsigned short keys() const { return _held; }
+
+ private:
+  unsigned short _held = 0;
+  unsigned short _pressed = 0;
+};
+
+/**
+ * @brief One run of identical frames.
+ */
+struct InputRun {
+  unsigned short keys;
+  unsigned short frames;
+};
+
+/**
+ * @class InputLog
+ * @brief Seed plus run-length keypad stream of a session.
+ *
+ * Idle play is one run; every change of held keys starts a new one, so a few
+ * minutes of play fit in a few hundred runs.
+ *
+ * @tparam MaxRuns Capacity; recording stops (record() returns false) when
+ * full
+ */
+template <int MaxRuns>
+class InputLog {
+ public:
+  static constexpr unsigned MAGIC = 0x4c495454;  // "TTIL"
+
+  constexpr explicit InputLog(unsigned seed = 0) : _seed(seed) {}
+
+  /** @brief Starts a new, empty recording. */
+  constexpr void clear(unsigned seed) {
+    _magic = MAGIC;
+    _seed = seed;
+    _run_count = 0;
+  }
+
+  /**
+   * @brief Appends one frame.
+   * @return False if the log is full and the frame was dropped.
+   */
+  constexpr bool record(unsigned short keys) {
+    if (_run_count > 0) {
+      InputRun &last = _runs[_run_count - 1];
+      if (last.keys == keys && last.frames < 0xffff) {
+        ++last.frames;
+        return true;
+      }
+    }
+    if (_run_count == MaxRuns) {
+      return false;
+    }
+    _runs[_run_count++] = InputRun{keys, 1};
+    return true;
+  }
+
+  /** @return Whether this looks like a log (e.g. after reading SRAM) */
+  [[nodiscard]] constexpr bool valid() const {
+    return _magic == MAGIC && _run_count >= 0 && _run_count <= MaxRuns;
+  }
+
+  [[nodiscard]] constexpr unsigned seed() const { return _seed; }
+  [[nodiscard]] constexpr int run_count() const { return _run_count; }
+  [[nodiscard]] constexpr const InputRun &run(int index) const {
+    return _runs[index];
+  }
+
+  [[nodiscard]] constexpr int frame_count() const {
+    int frames = 0;
+    for (int index = 0; index < _run_count; ++index) {
+      frames += _runs[index].frames;
+    }
+    return frames;
+  }
+
+ private:
+  unsigned _magic = MAGIC;
+  unsigned _seed;
+  int _run_count = 0;
+  InputRun _runs[MaxRuns] = {};
+};
+
+/**
+ * @class InputReplay
+ * @brief Plays an InputLog back frame by frame.
+ */
+template <int MaxRuns>
+class InputReplay {
+ public:
+  constexpr explicit InputReplay(const InputLog<MaxRuns> &log) : _log(log) {}
+
+  /**
+   * @brief Keys of the next recorded frame.
+   * @return False once every recorded frame has been played.
+   */
+  constexpr bool next(unsigned short &keys) {
+    while (_run < _log.run_count() && _frame == _log.run(_run).frames) {
+      ++_run;
+      _frame = 0;
+    }
+    if (_run == _log.run_count()) {
+      return false;
+    }
+    keys = _log.run(_run).keys;
+    ++_frame;
+    return true;
+  }
+
+ private:
+  const InputLog<MaxRuns> &_log;
+  int _run = 0;
+  int _frame = 0;
+};
+
+}  // namespace ti
+
+#endif
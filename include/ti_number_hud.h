@@ -0,0 +1,50 @@
+/**
+ * @file ti_number_hud.h
+ * @brief Declares NumberHud, a right-aligned "$123"-style counter drawn with
+ * one fixed 8x8 font sprite per character.
+ *
+ * Unlike bn::sprite_text_generator, nothing is rebuilt while the value stays
+ * the same, and a change only retiles the characters that differ.
+ */
+#ifndef TI_NUMBER_HUD_H
+#define TI_NUMBER_HUD_H
+
+#include "bn_sprite_palette_item.h"
+#include "bn_sprite_ptr.h"
+#include "bn_vector.h"
+#include "hud_glyphs.h"
+
+namespace ti {
+
+/**
+ * @class NumberHud
+ * @brief Numeric HUD widget with dirty tracking, using the game's sprite font.
+ */
+class NumberHud {
+ public:
+  static constexpr int SLOTS = 9;  // prefix + 8 digits, as bn::to_string<8>
+
+  /**
+   * @brief Creates the (hidden) character sprites.
+   * @param right_x Right edge of the text, like a right-aligned generate()
+   * @param y Vertical center of the text
+   * @param palette Palette for the font sprites
+   * @param prefix Character drawn before the number
+   */
+  NumberHud(int right_x, int y, const bn::sprite_palette_item &palette,
+            char prefix = '$');
+
+  /**
+   * @brief Shows a new value. Cheap to call every frame: returns right away
+   * when the value is unchanged.
+   */
+  void set_value(int value);
+
+ private:
+  bn::vector<bn::sprite_ptr, SLOTS> _sprites;  // slot 0 = rightmost
+  HudGlyphs<SLOTS> _glyphs;
+  int _right_x;
+};
+}  // namespace ti
+
+#endif
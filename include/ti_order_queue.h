@@ -0,0 +1,72 @@
+/**
+ * @file ti_order_queue.h
+ * @brief Declares OrderQueue, the line of customers waiting at the till.
+ *
+ * Customers join with a ticket and read their slot back in O(1) as
+ * ticket - head, so nobody scans the line. Serving the front customer bumps
+ * a generation counter; waiting customers only re-target when it changes.
+ */
+#ifndef TI_ORDER_QUEUE_H
+#define TI_ORDER_QUEUE_H
+
+#include "bn_fixed_point.h"
+#include "ti_cafe_layout.h"
+
+namespace ti {
+
+/**
+ * @class OrderQueue
+ * @brief Ticket-based FIFO with a configurable length of up to MAX_LENGTH.
+ */
+class OrderQueue {
+ public:
+  static constexpr int MAX_LENGTH = 8;
+  static constexpr int DEFAULT_LENGTH = 5;
+
+  /** @param length Customers that fit in line, clamped to 1..MAX_LENGTH */
+  explicit OrderQueue(int length = DEFAULT_LENGTH)
+      : _length(length < 1            ? 1
+                : length > MAX_LENGTH ? MAX_LENGTH
+                                      : length) {}
+
+  /**
+   * @brief Lines up a new customer at the back. Requires !full().
+   * @return Ticket to pass to slot(); stays valid until served.
+   */
+  int join() { return _tail++; }
+
+  /** @brief Serves the front customer; everyone else moves up one slot. */
+  void advance() {
+    ++_head;
+    ++_generation;
+  }
+
+  /** @return Place in line of a ticket, 0 at the till */
+  [[nodiscard]] int slot(int ticket) const { return ticket - _head; }
+
+  /** @return Where a customer stands in a slot; the line runs diagonally */
+  [[nodiscard]] static bn::fixed_point slot_position(int slot) {
+    const bn::fixed_point &front = CAFE_LAYOUT.queue_front;
+    const bn::fixed_point &spacing = CAFE_LAYOUT.queue_spacing;
+    return bn::fixed_point(front.x() + spacing.x() * slot,
+                           front.y() + spacing.y() * slot);
+  }
+
+  [[nodiscard]] int size() const { return _tail - _head; }
+  [[nodiscard]] bool empty() const { return _tail == _head; }
+  [[nodiscard]] bool full() const { return size() >= _length; }
+  [[nodiscard]] int length() const { return _length; }
+
+  /** @return Times the line has advanced; changes whenever slots shift */
+  [[nodiscard]] unsigned generation() const { return _generation; }
+
+ private:
+  int _length;
+  int _head = 0;
+  int _tail = 0;
+  unsigned _generation = 0;
+};
+
+}  // namespace ti
+
+#endif
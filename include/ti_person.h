@@ -1,213 +1,80 @@
 /**
  * @file ti_person.h
- * @brief Declares the Person class and types that control characters
- * (customers) in the cafe game.
+ * @brief Declares the Person class that draws a customer in the cafe game.
  *
- * STATE: Enum for character state machine (walking, ordering, etc).
- * TYPE: Visual/style enum for sprite appearance variants.
- * START: Enum for entry/exit position options.
+ * Person: Sprite, shadow and animation for one customer. All behavior lives
+ * in ti::PersonSim (ti_person_sim.h); Person only mirrors it on screen.
  *
- * Person: Represents a single customer in the game, their movement, animation,
- * and logic.
- *
- * Usage: Used by main game logic to simulate customer flow and interactions.
+ * Usage: main() keeps one Person per PersonSim in its ti::CrowdSim and calls
+ * update() with the crowd tick after the crowd has been simulated, then
+ * upload_frame() right after bn::core::update().
  */
 #ifndef TI_PERSON_H
 #define TI_PERSON_H
 
 #include "bn_blending.h"
-#include "bn_deque.h"
-#include "bn_fixed_point.h"
-#include "bn_optional.h"
-#include "bn_random.h"
-#include "bn_sprite_animate_actions.h"
-#include "bn_sprite_item.h"
 #include "bn_sprite_ptr.h"
-
-namespace ti {
-
-/**
- * @brief Represents the different states a customer can be in during their
- * lifecycle in the game.
- */
-enum class STATE {
-  WALKING_LEFT = 1,
-  WALKING_LEFT_W_COFFEE = 2,
-  WALKING_RIGHT = 3,
-  WALKING_RIGHT_W_COFFEE = 4,
-  ENTERING = 5,
-  WALKING_TO_ORDER = 6,
-  WAITING_TO_ORDER = 7,
-  ORDERING = 8,
-  WALKING_TO_COUNTER = 9,
-  WAITING = 10,
-  WALKING_TO_DOOR = 11,
-  EXITING = 12,
-  JOINING_QUEUE = 13,
-  WALKING_LEFT_PASSER = 14,
-  WALKING_RIGHT_PASSER = 15,
-};
-
-/**
- * @brief Enumerates all possible character sprite styles/types.
- */
-enum class TYPE {
-  GREEN_SHIRT = 0,
-  RED_SHIRT = 1,
-  BLUE_SHIRT = 2,
-  RED_SINGLET = 3,
-  DWIGHT = 4,
-  GIRL1 = 5,
-  GIRL2 = 6,
-  PALE_GREEN_SHIRT = 7,
-  GIRL3 = 8,
-  PERSON1 = 9,
-  PERSON2 = 10,
-  PERSON3 = 11,
-  PERSON4 = 12,
-  PERSON5 = 13
-};
-
-/**
- * @brief Entry locations for a Person: left side, right side, or at the
- * counter.
- */
-enum class START { LEFT, RIGHT, COUNTER };
-
-}  // namespace ti
+#include "bn_sprite_tiles_ptr.h"
+#include "ti_anim_clips.h"
+#include "ti_person_sim.h"
 
 namespace ti {
 
 /**
  * @class Person
- * @brief Models a customer character, handling movement, animation, queueing,
- * and ordering logic in the cafe.
+ * @brief Thin view of a customer: keeps a sprite and shadow in sync with a
+ * PersonSim and plays the animation clip it asks for.
+ *
+ * Frames come from a ClipPlayer and the crowd tick. Each customer owns VRAM
+ * for exactly one frame, and the sheet stays in ROM: when the shown frame
+ * changes, its tiles are copied into that slot during VBlank. VRAM per
+ * customer is thus the same however many frames or styles there are, and
+ * there is no tile cache churn as frames change. Customers walking outside
+ * the screen are hidden and skip all sprite work until they come back into
+ * view.
  *
- * Typical usage: Instantiated by the main game loop, repeatedly updated, and
- * rendered to the screen with a sprite and shadow.
+ * Typical usage: Instantiated by the main game loop next to its simulation,
+ * then updated once per frame after the simulation step.
  */
 class Person {
  private:
-  bn::optional<bn::sprite_ptr> _sprite;
-  bn::optional<bn::sprite_animate_action<8>> _action;
+  bn::sprite_tiles_ptr _tiles;  // this customer's one-frame slot
+  bn::sprite_ptr _sprite;
   bn::sprite_ptr _shadow;
-  bn::optional<bn::sprite_item> _sprite_item;
-  bn::fixed _speed = 0.3;
-  bn::random _random = bn::random();
-  TYPE _type = TYPE::GREEN_SHIRT;
-  int _wait_max = 320;
-  int _wait_time = 0;
-  STATE _state = STATE::WAITING;
-  void setStyle(TYPE type, START start, bn::fixed_point pos);
-  int _id;
-  bool _has_loitered = false;
-  bool _is_loitering = false;
-  int _loiter_time = 0;
-  int _loiter_duration_frames = 0;
-  bn::fixed_point _loiter_target_position = bn::fixed_point(0, 0);
-  bool _loiter_in_position = false;
-  static int _active_loiterers;
-  static constexpr int _max_loiterers = 3;
-  static constexpr int _walk_by_chance = 4;  // 1 in 4 chance to skip entering
-  bool _try_start_loitering();
-  void _begin_loitering();
-  void _stop_loitering();
-  bn::fixed_point _random_street_loiter_point();
-  bn::fixed _randomized_street_y(bn::fixed base_y);
-  bool _should_walk_by();
-  bool _update_loiter_overlay();
-  using StateHandler = void (Person::*)(bn::deque<int, 8> &, bool &, bool &,
-                                        bn::vector<int, 16> &);
-  static const StateHandler _state_handlers[];
-  static int _state_index(STATE state);
-  friend constexpr bool _ti_verify_state_handler_table();
-  bool _advance_to(const bn::fixed_point &target, bool may_loiter = false);
-  void _respawn_from_side(START start_side, STATE next_state, bool face_left,
-                          bn::vector<int, 16> &types);
-
-  void _handle_walking_left(bn::deque<int, 8> &order_queue, bool &waiting_spot,
-                            bool &purchased_this_frame,
-                            bn::vector<int, 16> &types);
-  void _handle_walking_left_with_coffee(bn::deque<int, 8> &order_queue,
-                                        bool &waiting_spot,
-                                        bool &purchased_this_frame,
-                                        bn::vector<int, 16> &types);
-  void _handle_walking_right(bn::deque<int, 8> &order_queue, bool &waiting_spot,
-                             bool &purchased_this_frame,
-                             bn::vector<int, 16> &types);
-  void _handle_walking_right_with_coffee(bn::deque<int, 8> &order_queue,
-                                         bool &waiting_spot,
-                                         bool &purchased_this_frame,
-                                         bn::vector<int, 16> &types);
-  void _handle_entering(bn::deque<int, 8> &order_queue, bool &waiting_spot,
-                        bool &purchased_this_frame, bn::vector<int, 16> &types);
-  void _handle_walking_to_order(bn::deque<int, 8> &order_queue,
-                                bool &waiting_spot, bool &purchased_this_frame,
-                                bn::vector<int, 16> &types);
-  void _handle_waiting_to_order(bn::deque<int, 8> &order_queue,
-                                bool &waiting_spot, bool &purchased_this_frame,
-                                bn::vector<int, 16> &types);
-  void _handle_ordering(bn::deque<int, 8> &order_queue, bool &waiting_spot,
-                        bool &purchased_this_frame, bn::vector<int, 16> &types);
-  void _handle_walking_to_counter(bn::deque<int, 8> &order_queue,
-                                  bool &waiting_spot,
-                                  bool &purchased_this_frame,
-                                  bn::vector<int, 16> &types);
-  void _handle_waiting(bn::deque<int, 8> &order_queue, bool &waiting_spot,
-                       bool &purchased_this_frame, bn::vector<int, 16> &types);
-  void _handle_walking_to_door(bn::deque<int, 8> &order_queue,
-                               bool &waiting_spot, bool &purchased_this_frame,
-                               bn::vector<int, 16> &types);
-  void _handle_exiting(bn::deque<int, 8> &order_queue, bool &waiting_spot,
-                       bool &purchased_this_frame, bn::vector<int, 16> &types);
-  void _handle_joining_queue(bn::deque<int, 8> &order_queue, bool &waiting_spot,
-                             bool &purchased_this_frame,
-                             bn::vector<int, 16> &types);
-  void _handle_walking_left_passer(bn::deque<int, 8> &order_queue,
-                                   bool &waiting_spot,
-                                   bool &purchased_this_frame,
-                                   bn::vector<int, 16> &types);
-  void _handle_walking_right_passer(bn::deque<int, 8> &order_queue,
-                                    bool &waiting_spot,
-                                    bool &purchased_this_frame,
-                                    bn::vector<int, 16> &types);
+  ClipPlayer _player;
+  signed char _frame = -1;  // sheet frame shown, -1 before the first one
+  TYPE _type;
+  bool _culled = false;         // hidden while fully offscreen
+  bool _frame_pending = false;  // _frame not copied into _tiles yet
+  void _show_frame(int tick);
+  void _cull();
 
  public:
   /**
-   * @brief Constructs a Person with the given starting location, type, and
-   * unique id.
-   * @param start Entry position (LEFT, RIGHT, COUNTER)
-   * @param type Visual/style type enum
-   * @param id Unique person id (used throughout the game's queue and logic
-   * flows)
+   * @brief Creates the sprite and shadow for a customer.
+   * @param sim Simulation state this view mirrors
+   * @param tick Current crowd tick
    */
-  Person(START start, TYPE type, int id);
+  Person(const PersonSim &sim, int tick);
 
   /**
-   * @brief Per-frame update for this character: controls position, state
-   * machine, ordering, and animation logic.
-   * @param order_queue Reference to the global queue of customer IDs
-   * @param waiting_spot Whether the alternate waiting spot is occupied
-   * @param purchased_this_frame Flag flipped when the character completes a
-   * purchase
-   * @param types List of available style types for recycling when respawning
+   * @brief Per-frame sync: copies position, facing, style and animation clip
+   * from the simulation and shows the clip frame for "tick".
+   * @param sim Simulation state this view mirrors
+   * @param tick Current crowd tick (see CrowdSim::tick())
    */
-  void update(bn::deque<int, 8> &order_queue, bool &waiting_spot,
-              bool &purchased_this_frame, bn::vector<int, 16> &types);
-
-  int get_id();
-  TYPE get_type();
-  bn::fixed_point TILL = bn::fixed_point(-66, 14);
-  bn::fixed_point COUNTER1 = bn::fixed_point(-100, 16);
-  bn::fixed_point COUNTER2 = bn::fixed_point(-86, 14);
-  bn::fixed_point DOOR = bn::fixed_point(88, 36);
-  bn::fixed_point OUTSIDE = bn::fixed_point(100, 60);
-  bn::fixed_point LEFT = bn::fixed_point(-140, 60);
-  bn::fixed_point RIGHT = bn::fixed_point(180, 60);
-  bn::fixed_point QUEUE_START = bn::fixed_point(0, 24);
+  void update(const PersonSim &sim, int tick);
 
-  bn::vector<bn::fixed_point, 5> LOCATIONS;
+  /**
+   * @brief Copies the frame update() picked into this customer's tiles, if
+   * it changed. Call right after bn::core::update(), while still in VBlank,
+   * so the slot is never rewritten while the screen draws it.
+   */
+  void upload_frame();
 };
+
+// bn::vector<Person, CrowdSim::MAX_PEOPLE> lives in main()'s stack frame.
+static_assert(sizeof(Person) <= 24, "Person grew past its size budget.");
 }  // namespace ti
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,237 @@
+/**
+ * @file ti_person_sim.h
+ * @brief Declares the render-free simulation of a single cafe customer.
+ *
+ * STATE: Enum for character state machine (walking, ordering, etc).
+ * TYPE: Visual/style enum for sprite appearance variants.
+ * START: Enum for entry/exit position options.
+ *
+ * PersonSim: Positions, state machine, queueing, wait timers and RNG for one
+ * customer. It never touches sprites, so it compiles both for the ROM and
+ * against tests/host_stubs. ti::Person (ti_person.h) draws it.
+ */
+#ifndef TI_PERSON_SIM_H
+#define TI_PERSON_SIM_H
+
+#include "bn_fixed_point.h"
+#include "ti_anim_clips.h"
+#include "ti_cafe_layout.h"
+#include "ti_order_queue.h"
+#include "ti_rng.h"
+#include "ti_style_pool.h"
+
+namespace ti {
+
+/**
+ * @brief Represents the different states a customer can be in during their
+ * lifecycle in the game.
+ */
+enum class STATE : unsigned char {
+  WALKING_LEFT = 1,
+  WALKING_LEFT_W_COFFEE = 2,
+  WALKING_RIGHT = 3,
+  WALKING_RIGHT_W_COFFEE = 4,
+  ENTERING = 5,
+  WALKING_TO_ORDER = 6,
+  WAITING_TO_ORDER = 7,
+  ORDERING = 8,
+  WALKING_TO_COUNTER = 9,
+  WAITING = 10,
+  WALKING_TO_DOOR = 11,
+  EXITING = 12,
+  JOINING_QUEUE = 13,
+  WALKING_LEFT_PASSER = 14,
+  WALKING_RIGHT_PASSER = 15,
+};
+
+/**
+ * @brief Enumerates all possible character sprite styles/types.
+ */
+enum class TYPE : unsigned char {
+  GREEN_SHIRT = 0,
+  RED_SHIRT = 1,
+  BLUE_SHIRT = 2,
+  RED_SINGLET = 3,
+  DWIGHT = 4,
+  GIRL1 = 5,
+  GIRL2 = 6,
+  PALE_GREEN_SHIRT = 7,
+  GIRL3 = 8,
+  PERSON1 = 9,
+  PERSON2 = 10,
+  PERSON3 = 11,
+  PERSON4 = 12,
+  PERSON5 = 13
+};
+
+/**
+ * @brief Entry locations for a Person: left side, right side, or at the
+ * counter.
+ */
+enum class START { LEFT, RIGHT, COUNTER };
+
+/**
+ * @class PersonSim
+ * @brief Simulation half of a customer: movement, queueing, ordering and
+ * loitering without any sprite work.
+ *
+ * The view reads position, facing, type and the requested animation clip
+ * (see ti_anim_clips.h) after each update.
+ */
+class PersonSim {
+ public:
+  // Behaviour constants, also read by EconomyModel (see ti_economy.h).
+  static constexpr int WAIT_MAX = 320;      // frames to order; pick-up +60
+  static constexpr int WALK_BY_CHANCE = 4;  // 1 in 4 chance to skip entering
+  static constexpr int LOITER_SECONDS_MIN = 2;
+  static constexpr int LOITER_SECONDS_SPREAD = 9;  // loiters 2 to 10 s
+  static constexpr int EXIT_LEFT_ODDS = 4;         // in 10; others go right
+
+ private:
+  bn::fixed_point _position;
+  bn::fixed _speed = 0.3;
+  Rng _random;  // this customer's own stream, see PersonSim()
+  int _wait_time = 0;
+  // State word: state machine, looks and flags share 4 bytes.
+  STATE _state = STATE::WAITING;
+  TYPE _type = TYPE::GREEN_SHIRT;
+  CLIP _clip = CLIP::WALK;
+  bool _face_left : 1;
+  bool _has_loitered : 1;
+  bool _is_loitering : 1;
+  bool _loiter_in_position : 1;
+  void setStyle(TYPE type, START start, bn::fixed_point pos);
+  void _play(CLIP clip);
+  int _id;
+  short _loiter_time = 0;
+  short _loiter_duration_frames = 0;
+  bn::fixed_point _loiter_target_position = bn::fixed_point(0, 0);
+  static constexpr int _max_loiterers = 3;
+  static constexpr int _loiter_chance_frames = 360;  // ~6 s between tries
+  bool _try_start_loitering(int &active_loiterers);
+  void _begin_loitering(int &active_loiterers);
+  void _stop_loitering(int &active_loiterers);
+  bn::fixed_point _random_street_loiter_point();
+  bn::fixed _randomized_street_y(bn::fixed base_y);
+  bool _should_walk_by();
+  bool _update_loiter_overlay(int &active_loiterers);
+  using StateHandler = void (PersonSim::*)(OrderQueue &, bool &, bool &,
+                                           StylePool &, int &);
+  static const StateHandler _state_handlers[];
+  static int _state_index(STATE state);
+  friend constexpr bool _ti_verify_state_handler_table();
+  bn::fixed_point _leg_target;
+  bn::fixed_point _leg_step;
+  int _leg_steps_left = -1;  // -1: no leg cached
+  void _start_leg(const bn::fixed_point &target);
+  // Walks one step; passing the crowd's loiterer count lets it stop to
+  // loiter on the way.
+  bool _advance_to(const bn::fixed_point &target,
+                   int *active_loiterers = nullptr);
+  int _queue_ticket = -1;  // -1: not in the order queue
+  unsigned _queue_generation = 0;
+  bn::fixed_point _queue_spot;
+  const bn::fixed_point &_queue_spot_in(const OrderQueue &order_queue);
+  void _respawn_from_side(START start_side, STATE next_state, bool face_left,
+                          StylePool &styles);
+
+  void _handle_walking_left(OrderQueue &order_queue, bool &waiting_spot,
+                            bool &purchased_this_frame, StylePool &styles,
+                            int &active_loiterers);
+  void _handle_walking_left_with_coffee(OrderQueue &order_queue,
+                                        bool &waiting_spot,
+                                        bool &purchased_this_frame,
+                                        StylePool &styles,
+                                        int &active_loiterers);
+  void _handle_walking_right(OrderQueue &order_queue, bool &waiting_spot,
+                             bool &purchased_this_frame, StylePool &styles,
+                             int &active_loiterers);
+  void _handle_walking_right_with_coffee(OrderQueue &order_queue,
+                                         bool &waiting_spot,
+                                         bool &purchased_this_frame,
+                                         StylePool &styles,
+                                         int &active_loiterers);
+  void _handle_entering(OrderQueue &order_queue, bool &waiting_spot,
+                        bool &purchased_this_frame, StylePool &styles,
+                        int &active_loiterers);
+  void _handle_walking_to_order(OrderQueue &order_queue, bool &waiting_spot,
+                                bool &purchased_this_frame, StylePool &styles,
+                                int &active_loiterers);
+  void _handle_waiting_to_order(OrderQueue &order_queue, bool &waiting_spot,
+                                bool &purchased_this_frame, StylePool &styles,
+                                int &active_loiterers);
+  void _handle_ordering(OrderQueue &order_queue, bool &waiting_spot,
+                        bool &purchased_this_frame, StylePool &styles,
+                        int &active_loiterers);
+  void _handle_walking_to_counter(OrderQueue &order_queue, bool &waiting_spot,
+                                  bool &purchased_this_frame, StylePool &styles,
+                                  int &active_loiterers);
+  void _handle_waiting(OrderQueue &order_queue, bool &waiting_spot,
+                       bool &purchased_this_frame, StylePool &styles,
+                       int &active_loiterers);
+  void _handle_walking_to_door(OrderQueue &order_queue, bool &waiting_spot,
+                               bool &purchased_this_frame, StylePool &styles,
+                               int &active_loiterers);
+  void _handle_exiting(OrderQueue &order_queue, bool &waiting_spot,
+                       bool &purchased_this_frame, StylePool &styles,
+                       int &active_loiterers);
+  void _handle_joining_queue(OrderQueue &order_queue, bool &waiting_spot,
+                             bool &purchased_this_frame, StylePool &styles,
+                             int &active_loiterers);
+  void _handle_walking_left_passer(OrderQueue &order_queue, bool &waiting_spot,
+                                   bool &purchased_this_frame,
+                                   StylePool &styles, int &active_loiterers);
+  void _handle_walking_right_passer(OrderQueue &order_queue, bool &waiting_spot,
+                                    bool &purchased_this_frame,
+                                    StylePool &styles, int &active_loiterers);
+
+ public:
+  /**
+   * @brief Constructs a customer with the given starting location, type, and
+   * unique id.
+   * @param start Entry position (LEFT, RIGHT, COUNTER)
+   * @param type Visual/style type enum
+   * @param id Unique person id (used throughout the game's queue and logic
+   * flows)
+   * @param seed Crowd-wide seed; the customer draws from stream "id" of it
+   */
+  PersonSim(START start, TYPE type, int id,
+            unsigned seed = Rng::DEFAULT_SEED);
+
+  /**
+   * @brief Per-frame update for this character: controls position, state
+   * machine, ordering, and which animation clip should play.
+   * @param order_queue The line at the till, shared by the crowd
+   * @param waiting_spot Whether the alternate waiting spot is occupied
+   * @param purchased_this_frame Flag flipped when the character completes a
+   * purchase
+   * @param styles Free styles; respawning returns its style and claims one
+   * if StylePool::can_change() allows it
+   * @param active_loiterers Customers of the crowd loitering right now;
+   * starting or ending a loiter updates it
+   */
+  void update(OrderQueue &order_queue, bool &waiting_spot,
+              bool &purchased_this_frame, StylePool &styles,
+              int &active_loiterers);
+
+  int get_id() const;
+  TYPE get_type() const;
+  /** @brief Changes style only; for customers out of play */
+  void set_type(TYPE type);
+  STATE get_state() const;
+  const bn::fixed_point &get_position() const;
+  bn::fixed get_speed() const;
+  bool is_facing_left() const;
+  CLIP get_clip() const;
+};
+
+/**
+ * @brief Upper bound on sizeof(PersonSim). Fields are 32-bit or smaller on
+ * both the GBA and the host stubs, so host tests check the same number.
+ */
+constexpr int PERSON_SIM_SIZE_BUDGET = 80;
+static_assert(sizeof(PersonSim) <= PERSON_SIM_SIZE_BUDGET,
+              "PersonSim grew past its size budget.");
+}  // namespace ti
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ * @file ti_profiler.h
+ * @brief Scoped per-zone frame-time profiler for the main loop.
+ *
+ * TI_PROFILE_SCOPE(zone) times the rest of the enclosing block and folds it
+ * into the min/avg/max of that zone. Unless TI_PROFILER_ENABLED is defined
+ * (e.g. make USERFLAGS=-DTI_PROFILER_ENABLED, see `just build-profile`) the
+ * macro expands to nothing, so zones can stay in the code permanently.
+ *
+ * On the GBA, ticks come from a free-running bn::timer (64 CPU cycles
+ * each), so a zone that runs past VBlank is measured in full rather than
+ * modulo one frame; samples longer than TICKS_PER_FRAME count as overruns.
+ * With TI_PROFILER_HOST_CLOCK (host tests) ticks are std::chrono
+ * nanoseconds instead.
+ */
+#ifndef TI_PROFILER_H
+#define TI_PROFILER_H
+
+#ifdef TI_PROFILER_HOST_CLOCK
+#include <chrono>
+#else
+#include "bn_timer.h"
+#endif
+
+namespace ti {
+
+/**
+ * @brief Parts of a frame that are timed separately.
+ */
+enum class PROFILE_ZONE : unsigned char {
+  INPUT,    // menu and cursor handling
+  SIM,      // every sim tick of a frame (1, or 4/8 in turbo)
+  AMBIENT,  // timers and ambient sprite animations, per tick
+  CROWD,    // CrowdSim::update, per tick
+  HUD,      // cash counter
+  PEOPLE,   // syncing every Person view
+  PERSON,   // a single Person::update
+  CORE,     // bn::core::update, including the wait for VBlank
+  TILES,    // customer frame uploads, in VBlank
+};
+
+constexpr int PROFILE_ZONE_COUNT = 9;
+
+constexpr const char *PROFILE_ZONE_NAMES[] = {
+    "input", "sim",    "ambient", "crowd", "hud",
+    "people", "person", "core",   "tiles",
+};
+
+static_assert(sizeof(PROFILE_ZONE_NAMES) / sizeof(PROFILE_ZONE_NAMES[0]) ==
+                  PROFILE_ZONE_COUNT,
+              "Zone names must match PROFILE_ZONE enum.");
+
+/**
+ * @brief Running min/avg/max of one zone's samples, in ticks.
+ */
+struct ProfileStats {
+  int samples = 0;
+  int overruns = 0;  // samples longer than one frame
+  int min = 0;
+  int max = 0;
+  long long total = 0;
+
+  constexpr void add(int ticks) {
+    if (samples == 0 || ticks < min) {
+      min = ticks;
+    }
+    if (samples == 0 || ticks > max) {
+      max = ticks;
+    }
+    total += ticks;
+    ++samples;
+  }
+
+  [[nodiscard]] constexpr int average() const {
+    return samples == 0 ? 0 : int(total / samples);
+  }
+};
+
+/**
+ * @class Profiler
+ * @brief Clock source plus the stats of every zone.
+ */
+class Profiler {
+ public:
+#ifdef TI_PROFILER_HOST_CLOCK
+  static constexpr int TICKS_PER_WRAP = 1000000000;
+  static constexpr int TICKS_PER_FRAME = 16742706;  // 280896 cycles
+
+  static int now() {
+    auto since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+    return int(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   since_epoch)
+                   .count() %
+               TICKS_PER_WRAP);
+  }
+#else
+  static constexpr int TICKS_PER_WRAP = 1 << 30;
+  static constexpr int TICKS_PER_FRAME = 280896 / 64;  // 4389
+
+  static int now() {
+    // Started on the first zone, after bn::core::init().
+    static bn::timer clock;
+    return clock.elapsed_ticks() & (TICKS_PER_WRAP - 1);
+  }
+#endif
+
+  /** @return Ticks from "start" to "end", allowing for one clock wrap */
+  [[nodiscard]] static constexpr int elapsed(int start, int end) {
+    return end >= start ? end - start : end + TICKS_PER_WRAP - start;
+  }
+
+  static void record(PROFILE_ZONE zone, int ticks) {
+    ProfileStats &stats = _stats[static_cast<int>(zone)];
+    stats.add(ticks);
+    if (ticks > TICKS_PER_FRAME) {
+      ++stats.overruns;
+    }
+  }
+
+  [[nodiscard]] static const ProfileStats &stats(PROFILE_ZONE zone) {
+    return _stats[static_cast<int>(zone)];
+  }
+
+  static void reset() {
+    for (ProfileStats &stats : _stats) {
+      stats = ProfileStats();
+    }
+  }
+
+ private:
+  static inline ProfileStats _stats[PROFILE_ZONE_COUNT];
+};
+
+/**
+ * @class ProfileScope
+ * @brief Records the time between its construction and destruction.
+ */
+class ProfileScope {
+ public:
+  explicit ProfileScope(PROFILE_ZONE zone)
+      : _zone(zone), _start(Profiler::now()) {}
+  ~ProfileScope() {
+    Profiler::record(_zone, Profiler::elapsed(_start, Profiler::now()));
+  }
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+ private:
+  PROFILE_ZONE _zone;
+  int _start;
+};
+
+}  // namespace ti
+
+#define TI_PROFILE_JOIN_IMPL(a, b) a##b
+#define TI_PROFILE_JOIN(a, b) TI_PROFILE_JOIN_IMPL(a, b)
+
+#ifdef TI_PROFILER_ENABLED
+#define TI_PROFILE_SCOPE(zone) \
+  ::ti::ProfileScope TI_PROFILE_JOIN(ti_profile_scope_, __LINE__)(zone)
+#else
+#define TI_PROFILE_SCOPE(zone) static_cast<void>(0)
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file ti_rng.h
+ * @brief Small splittable random number generator with per-entity streams.
+ *
+ * Rng is a 32-bit PCG (LCG step, RXS-M-XS output). Each stream has its own
+ * LCG increment, so Rng::stream(seed, id) hands every customer or ambient
+ * actor an independent sequence in O(1), instead of spinning a shared
+ * generator "id" times. Everything is 32-bit multiplies, shifts and xors:
+ * get_int() scales by the high word of a 32x32->64 product rather than
+ * dividing, since the GBA has no divide instruction.
+ *
+ * The interface mirrors bn::random, so it drops in wherever that was used,
+ * and at 8 bytes a stream per customer stays within PersonSim's size budget.
+ */
+#ifndef TI_RNG_H
+#define TI_RNG_H
+
+#include "bn_fixed.h"
+
+namespace ti {
+
+/**
+ * @class Rng
+ * @brief One stream of pseudo-random numbers.
+ */
+class Rng {
+ public:
+  static constexpr unsigned DEFAULT_SEED = 0x853c49e6;
+
+  constexpr Rng() : Rng(DEFAULT_SEED) {}
+
+  /** @brief Stream 0 of "seed". */
+  constexpr explicit Rng(unsigned seed) { set_seed(seed); }
+
+  /**
+   * @return Stream "id" of "seed": independent of every other stream of the
+   * same seed, and as cheap to create as any.
+   */
+  [[nodiscard]] static constexpr Rng stream(unsigned seed, unsigned id) {
+    Rng rng;
+    rng._seed(seed, id);
+    return rng;
+  }
+
+  /** @brief Restarts stream 0 of "seed". */
+  constexpr void set_seed(unsigned seed) { _seed(seed, 0); }
+
+  /** @return 32 random bits */
+  constexpr unsigned get() {
+    const unsigned state = _state;
+    _state = state * 747796405u + _increment;
+    const unsigned word =
+        ((state >> ((state >> 28) + 4)) ^ state) * 277803737u;
+    return (word >> 22) ^ word;
+  }
+
+  /** @return A number in [0, limit); limit must be positive */
+  constexpr int get_int(int limit) {
+    return int((static_cast<unsigned long long>(get()) * unsigned(limit)) >>
+               32);
+  }
+
+  /** @return A number in [0, limit) */
+  [[nodiscard]] bn::fixed get_fixed(bn::fixed limit) {
+    return bn::fixed::from_data(get_int(limit.data()));
+  }
+
+  /**
+   * @brief Batch of get_int(limit) draws, e.g. for every ambient actor at
+   * once; same values as calling get_int() "count" times.
+   */
+  constexpr void get_ints(int limit, int *values, int count) {
+    for (int index = 0; index < count; ++index) {
+      values[index] = get_int(limit);
+    }
+  }
+
+ private:
+  constexpr void _seed(unsigned seed, unsigned id) {
+    _increment = (id << 1) | 1;
+    _state = 0;
+    get();
+    _state += seed;
+    get();
+  }
+
+  unsigned _state = 0;
+  unsigned _increment = 1;  // odd; tells the streams apart
+};
+
+}  // namespace ti
+
+#endif
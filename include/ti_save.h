@@ -0,0 +1,72 @@
+/**
+ * @file ti_save.h
+ * @brief Progress kept in SRAM between sessions, no dependencies.
+ *
+ * SaveData: Cash, bought upgrades and when the game was last saved, so the
+ * next boot can credit the time away (see ti_economy.h).
+ * clock_seconds(): Flattens a cartridge RTC reading into seconds.
+ *
+ * This header is standalone/test-friendly and designed for use in both
+ * host-side unit tests and embedded game builds.
+ */
+#ifndef TI_SAVE_H
+#define TI_SAVE_H
+
+namespace ti {
+
+/**
+ * @brief Seconds since 2000-01-01 00:00:00 of a calendar date and time.
+ * @param year Two-digit year as the RTC reports it (0 is 2000)
+ * @param month 1 to 12
+ * @param month_day 1 to 31
+ */
+[[nodiscard]] constexpr long long clock_seconds(int year, int month,
+                                                int month_day, int hour,
+                                                int minute, int second) {
+  constexpr int DAYS_BEFORE_MONTH[] = {0,   31,  59,  90,  120, 151,
+                                       181, 212, 243, 273, 304, 334};
+  long long days = 365LL * year + (year + 3) / 4;  // 2000 is a leap year
+  days += DAYS_BEFORE_MONTH[month - 1] + month_day - 1;
+  if (month > 2 && year % 4 == 0) {
+    ++days;
+  }
+  return ((days * 24 + hour) * 60 + minute) * 60 + second;
+}
+
+/**
+ * @brief Saved progress; plain data so bn::sram can copy it as is.
+ */
+struct SaveData {
+  static constexpr unsigned MAGIC = 0x56415354;  // "TSAV"
+  static constexpr long long NO_CLOCK = -1;
+  // Longest absence credited. A bigger jump is as likely a reset or
+  // misread clock as a long holiday, so it isn't worth more than this.
+  static constexpr long long MAX_SECONDS_AWAY = 3LL * 24 * 60 * 60;
+
+  unsigned magic = MAGIC;
+  int cash = 0;
+  unsigned bought = 0;            // bit i: wishlist item i is bought
+  long long saved_at = NO_CLOCK;  // clock_seconds(), if there is an RTC
+
+  /** @return Whether this looks like a save (e.g. after reading SRAM) */
+  [[nodiscard]] constexpr bool valid() const {
+    return magic == MAGIC && cash >= 0;
+  }
+
+  /**
+   * @return Seconds between saving and "now", at most MAX_SECONDS_AWAY, or
+   * 0 if either time is unknown (any negative reading) or the clock went
+   * backwards.
+   */
+  [[nodiscard]] constexpr long long seconds_away(long long now) const {
+    if (saved_at < 0 || now < 0 || now < saved_at) {
+      return 0;
+    }
+    return now - saved_at < MAX_SECONDS_AWAY ? now - saved_at
+                                             : MAX_SECONDS_AWAY;
+  }
+};
+
+}  // namespace ti
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file ti_style_pool.h
+ * @brief Declares StylePool, the set of customer styles (TYPE values) not
+ * worn by anyone currently in play.
+ *
+ * Replaces rebuilding a vector of free styles every frame: the crowd acquires
+ * a style when a customer enters play, and a respawning customer picks a free
+ * style, acquires it and releases its old one. Every operation is O(1).
+ *
+ * Every style worn is a palette bank on screen, so the pool can also cap how
+ * many distinct styles are worn at once.
+ */
+#ifndef TI_STYLE_POOL_H
+#define TI_STYLE_POOL_H
+
+namespace ti {
+
+/**
+ * @class StylePool
+ * @brief Bitmask of free styles plus a wearer count per style, so styles
+ * shared by several customers (everyone starts as GREEN_SHIRT) stay taken
+ * until the last one lets go.
+ */
+class StylePool {
+ public:
+  static constexpr int MAX_STYLES = 16;
+
+  /**
+   * @param style_count Styles 0..style_count-1 start out free
+   * @param max_worn Most distinct styles can_change() lets be worn at once
+   */
+  explicit StylePool(int style_count, int max_worn = MAX_STYLES)
+      : _free_mask((1u << style_count) - 1),
+        _max_worn(max_worn),
+        _wearers{} {}
+
+  void acquire(int style) {
+    if (_wearers[style]++ == 0) {
+      ++_worn_count;
+    }
+    _free_mask &= ~(1u << style);
+  }
+
+  void release(int style) {
+    if (_wearers[style] > 0 && --_wearers[style] == 0) {
+      _free_mask |= 1u << style;
+      --_worn_count;
+    }
+  }
+
+  [[nodiscard]] bool is_free(int style) const {
+    return _free_mask & (1u << style);
+  }
+
+  [[nodiscard]] bool empty() const { return _free_mask == 0; }
+
+  [[nodiscard]] int free_count() const {
+    return __builtin_popcount(_free_mask);
+  }
+
+  /** @return Distinct styles worn by at least one customer */
+  [[nodiscard]] int worn_count() const { return _worn_count; }
+
+  /** @return True if one more distinct style may be worn */
+  [[nodiscard]] bool can_wear_another() const {
+    return _worn_count < _max_worn;
+  }
+
+  /**
+   * @brief Whether a wearer of "style" may swap it for a free one: there is
+   * one, and either a style is to spare or this wearer's style goes free.
+   */
+  [[nodiscard]] bool can_change(int style) const {
+    return !empty() && (can_wear_another() || _wearers[style] == 1);
+  }
+
+  /**
+   * @brief Uniformly picks a free style. Draws exactly like indexing a sorted
+   * vector of free styles with rng.get_int(size). Requires !empty().
+   * @param rng bn::random, ti::Rng or anything else with get_int()
+   */
+  template <typename Random>
+  [[nodiscard]] int pick(Random &rng) const {
+    unsigned mask = _free_mask;
+    for (int skip = rng.get_int(free_count()); skip > 0; --skip) {
+      mask &= mask - 1;
+    }
+    return __builtin_ctz(mask);
+  }
+
+ private:
+  unsigned _free_mask;
+  int _max_worn;
+  int _worn_count = 0;
+  unsigned char _wearers[MAX_STYLES];
+};
+
+}  // namespace ti
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * @file ti_timer_wheel.h
+ * @brief Hashed timer wheel for one-shot wake-ups, no dependencies.
+ *
+ * Each timer id has at most one pending wake-up. Scheduling and cancelling
+ * are O(1) plus a walk of one slot; advancing a tick only visits the slot
+ * for that tick, so idle timers cost nothing per frame however many exist.
+ * Delays longer than the wheel wrap around with a lap count.
+ *
+ * This header is standalone/test-friendly and designed for use in both
+ * host-side unit tests and embedded game builds.
+ */
+#ifndef TI_TIMER_WHEEL_H
+#define TI_TIMER_WHEEL_H
+
+namespace ti {
+
+/**
+ * @class TimerWheel
+ * @brief Fires timer ids on the tick they are due.
+ *
+ * @tparam MaxTimers Timer ids are 0..MaxTimers-1
+ * @tparam Slots Wheel size; a power of two
+ */
+template <int MaxTimers, int Slots = 64>
+class TimerWheel {
+  static_assert(MaxTimers > 0 && MaxTimers < 0x7fff, "Too many timers.");
+  static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0,
+                "Slots must be a power of two.");
+
+ public:
+  constexpr TimerWheel() {
+    for (short &head : _heads) {
+      head = NONE;
+    }
+  }
+
+  /**
+   * @brief Wakes "id" "delay" ticks from now, replacing any pending wake-up.
+   * @param delay Ticks to wait, at least 1
+   */
+  constexpr void schedule(int id, int delay) {
+    cancel(id);
+    if (delay < 1) {
+      delay = 1;
+    }
+    Timer &timer = _timers[id];
+    timer.laps = (delay - 1) / Slots;
+    timer.pending = true;
+    _link(id, (_now + delay) & MASK);
+  }
+
+  /** @brief Drops the pending wake-up of "id", if any. */
+  constexpr void cancel(int id) {
+    Timer &timer = _timers[id];
+    timer.due = false;
+    if (!timer.pending) {
+      return;
+    }
+    timer.pending = false;
+    short *link = &_heads[timer.slot];
+    while (*link != id) {
+      link = &_timers[*link].next;
+    }
+    *link = timer.next;
+  }
+
+  [[nodiscard]] constexpr bool pending(int id) const {
+    return _timers[id].pending;
+  }
+
+  /** @return Ticks advanced so far */
+  [[nodiscard]] constexpr unsigned now() const { return _now; }
+
+  /**
+   * @brief Moves to the next tick and calls fire(id) for every id due on it.
+   *
+   * fire() may schedule or cancel any timer, including the one firing. The
+   * due ids are detached before the first call, so a timer due on this tick
+   * that an earlier call rescheduled or cancelled is skipped.
+   */
+  template <typename Fire>
+  constexpr void advance(Fire &&fire) {
+    ++_now;
+    const int slot = _now & MASK;
+    short id = _heads[slot];
+    _heads[slot] = NONE;
+    short due[MaxTimers] = {};
+    int due_count = 0;
+    while (id != NONE) {
+      Timer &timer = _timers[id];
+      const short next = timer.next;
+      if (timer.laps > 0) {
+        --timer.laps;
+        _link(id, slot);
+      } else {
+        timer.pending = false;
+        timer.due = true;
+        due[due_count++] = id;
+      }
+      id = next;
+    }
+    // The slot list is newest first; fire in the order they were scheduled.
+    for (int i = due_count - 1; i >= 0; --i) {
+      Timer &timer = _timers[due[i]];
+      if (!timer.due) {
+        continue;
+      }
+      timer.due = false;
+      fire(int(due[i]));
+    }
+  }
+
+ private:
+  static constexpr short NONE = -1;
+  static constexpr int MASK = Slots - 1;
+
+  struct Timer {
+    short next = NONE;
+    short slot = 0;
+    unsigned short laps = 0;
+    bool pending = false;
+    bool due = false;
+  };
+
+  constexpr void _link(int id, int slot) {
+    Timer &timer = _timers[id];
+    timer.slot = short(slot);
+    timer.next = _heads[slot];
+    _heads[slot] = short(id);
+  }
+
+  Timer _timers[MaxTimers] = {};
+  short _heads[Slots] = {};
+  unsigned _now = 0;
+};
+
+}  // namespace ti
+
+#endif
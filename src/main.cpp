@@ -8,13 +8,14 @@
 
 #include "bn_blending.h"
 #include "bn_core.h"
+#include "bn_date.h"
 #include "bn_deque.h"
 #include "bn_display.h"
 #include "bn_keypad.h"
 #include "bn_log.h"
 #include "bn_music.h"
 #include "bn_music_items.h"
-#include "bn_random.h"
+#include "bn_optional.h"
 #include "bn_regular_bg_items_bg1.h"
 #include "bn_regular_bg_items_overlay.h"
 #include "bn_regular_bg_ptr.h"
@@ -50,10 +51,24 @@
 #include "bn_sprite_palette_items_white_text_palette.h"
 #include "bn_sprite_palette_ptr.h"
 #include "bn_sprite_text_generator.h"
+#include "bn_sram.h"
+#include "bn_sstream.h"
 #include "bn_string.h"
+#include "bn_time.h"
+#include "bn_timer.h"
+#include "bn_timers.h"
+#include "ti_anim_registry.h"
+#include "ti_crowd_sim.h"
+#include "ti_economy.h"
 #include "ti_font.h"
 #include "ti_helpers.h"
+#include "ti_input_log.h"
+#include "ti_number_hud.h"
 #include "ti_person.h"
+#include "ti_profiler.h"
+#include "ti_rng.h"
+#include "ti_save.h"
+#include "ti_timer_wheel.h"
 
 namespace {
 bn::fixed_point get_cursor_pos(int index) {
@@ -62,13 +77,113 @@ bn::fixed_point get_cursor_pos(int index) {
 
 // Return true with probability numerator/denominator using provided RNG.
 // numerator: number of successful outcomes; denominator: total outcomes.
-inline bool chance(bn::random& rng, int numerator, int denominator = 100) {
+inline bool chance(ti::Rng& rng, int numerator, int denominator = 100) {
   if (denominator <= 0) return false;
   if (numerator <= 0) return false;
   if (numerator >= denominator) return true;
   return rng.get_int(denominator) < numerator;
 }
 
+// Progress is saved at the start of SRAM, every minute and after each
+// upgrade.
+constexpr int SAVE_SRAM_OFFSET = 0;
+constexpr int AUTOSAVE_FRAMES = 60 * 60;
+
+// Seconds since 2000 on the cartridge clock, or NO_CLOCK without an RTC.
+long long read_clock() {
+  const bn::optional<bn::date> date = bn::date::current();
+  const bn::optional<bn::time> time = bn::time::current();
+  if (!date || !time) {
+    return ti::SaveData::NO_CLOCK;
+  }
+  return ti::clock_seconds(date->year(), date->month(), date->month_day(),
+                           time->hour(), time->minute(), time->second());
+}
+
+// The popularity bar has frames 0 to 10; popularity itself may go higher.
+constexpr int POPULARITY_BAR_MAX = 10;
+
+int popularity_bar_frame(int popularity_level) {
+  return popularity_level < POPULARITY_BAR_MAX ? popularity_level
+                                               : POPULARITY_BAR_MAX;
+}
+
+// Ambient characters and props, in the order they roll. Each one wakes on a
+// timer wheel when it next rolls for something to do, and is only updated
+// while it animates, so idle actors cost nothing per frame.
+enum class AMBIENT : unsigned char {
+  BARISTA,
+  TILL,
+  STEAM,
+  DRINKER,
+  TALKATIVE,
+  TYPIST,
+  PIGEON,
+  PIGEON2,
+  REFLECT,  // everything before this rolls every AMBIENT_ROLL_FRAMES
+  BUSTLE,
+  SYLVESTER,
+  CLOCK,
+  TWINKLE,
+};
+
+constexpr int AMBIENT_COUNT = 13;
+constexpr int AMBIENT_ROLL_FRAMES = 31;
+constexpr int BUSTLE_FRAMES = 60 * 29 + 2;
+constexpr int REFLECT_MEAN_FRAMES = 1000;
+
+// Ambient animations that drive an upgrade sprite; they stay suspended
+// until the upgrade is bought.
+struct UpgradeAnimation {
+  int upgrade;
+  AMBIENT actor;
+};
+
+constexpr UpgradeAnimation UPGRADE_ANIMATIONS[] = {
+    {0, AMBIENT::CLOCK},
+    {7, AMBIENT::SYLVESTER},
+    {8, AMBIENT::TYPIST},
+};
+
+// Steps an animation that may already be done; true once it is.
+template <typename Action>
+bool step_animation(Action& action) {
+  if (!action.done()) {
+    action.update();
+  }
+  return action.done();
+}
+
+// Recorded sessions go after the save data in SRAM.
+constexpr int INPUT_LOG_RUNS = 1024;
+constexpr int INPUT_LOG_SRAM_OFFSET = 1024;
+using SessionLog = ti::InputLog<INPUT_LOG_RUNS>;
+BN_DATA_EWRAM SessionLog session_log;
+
+enum class INPUT_MODE { LIVE, RECORDING, REPLAYING };
+
+unsigned short read_keypad() {
+  unsigned short keys = 0;
+  for (int bit = 0; bit < ti::KEY_COUNT; ++bit) {
+    if (bn::keypad::held(static_cast<bn::keypad::key_type>(1 << bit))) {
+      keys |= 1 << bit;
+    }
+  }
+  return keys;
+}
+
+// Sim ticks per displayed frame: hold R for turbo, L+R for double turbo.
+// The SIM profiler zone shows whether a frame's worth still fits in one.
+constexpr int TURBO_TICKS = 4;
+constexpr int DOUBLE_TURBO_TICKS = 8;
+
+int sim_ticks_per_frame(const ti::FrameInput& input) {
+  if (!input.held(ti::KEY_R)) {
+    return 1;
+  }
+  return input.held(ti::KEY_L) ? DOUBLE_TURBO_TICKS : TURBO_TICKS;
+}
+
 void redraw_wishlist(bn::sprite_text_generator& text_generator,
                      bn::vector<bn::sprite_ptr, 60>& text_sprites,
                      bn::vector<int, 16>& prices) {
@@ -96,6 +211,52 @@ void redraw_wishlist(bn::sprite_text_generator& text_generator,
   }
   return;
 }
+
+#ifdef TI_PROFILER_ENABLED
+// SELECT toggles the per-zone min/avg/max overlay (in timer ticks, with a
+// count of samples longer than a frame); START logs every zone through
+// bn::log and restarts the stats.
+void update_profiler_overlay(const ti::FrameInput& input,
+                             bn::sprite_text_generator& text_generator,
+                             bn::vector<bn::sprite_ptr, 56>& sprites,
+                             bool& shown) {
+  static int frames_until_redraw = 0;
+  if (input.pressed(ti::KEY_SELECT)) {
+    shown = !shown;
+    sprites.clear();
+    frames_until_redraw = 0;
+  }
+  if (input.pressed(ti::KEY_START)) {
+    for (int zone = 0; zone < ti::PROFILE_ZONE_COUNT; ++zone) {
+      const ti::ProfileStats& stats =
+          ti::Profiler::stats(static_cast<ti::PROFILE_ZONE>(zone));
+      BN_LOG(ti::PROFILE_ZONE_NAMES[zone], " min ", stats.min, " avg ",
+             stats.average(), " max ", stats.max, " n ", stats.samples,
+             " over ", stats.overruns);
+    }
+    ti::Profiler::reset();
+  }
+  if (!shown || --frames_until_redraw > 0) {
+    return;
+  }
+
+  frames_until_redraw = 30;
+  sprites.clear();
+  text_generator.set_left_alignment();
+  for (int zone = 0; zone < ti::PROFILE_ZONE_COUNT; ++zone) {
+    const ti::ProfileStats& stats =
+        ti::Profiler::stats(static_cast<ti::PROFILE_ZONE>(zone));
+    bn::string<32> line;
+    bn::ostringstream stream(line);
+    stream << ti::PROFILE_ZONE_NAMES[zone] << ' ' << stats.min << '/'
+           << stats.average() << '/' << stats.max;
+    if (stats.overruns > 0) {
+      stream << " !" << stats.overruns;
+    }
+    text_generator.generate(-116, -56 + zone * 10, line, sprites);
+  }
+}
+#endif
 }  // namespace
 
 int main() {
@@ -103,10 +264,12 @@ int main() {
 
   bn::sprite_text_generator text_generator(ti::variable_8x8_sprite_font);
   bn::vector<bn::sprite_ptr, 60> text_sprites;
-  bn::vector<bn::sprite_ptr, 4> cash_text_sprites;
   text_generator.set_bg_priority(0);
+  text_generator.set_palette_item(bn::sprite_palette_items::black_text_palette);
 
   int cash = 535;
+  ti::NumberHud cash_hud(-21, -71,
+                         bn::sprite_palette_items::white_text_palette);
   int popularity_level = 1;
   bn::sprite_ptr popularity_bar =
       bn::sprite_items::popularity_bar.create_sprite(-79, -73,
@@ -126,6 +289,7 @@ int main() {
     int price;
     bn::fixed_point pos;
     const bn::sprite_item* sprite_item;
+    int z_order = 0;
   };
 
   auto generate_wishlist = []() -> bn::vector<WishlistItem, 16> {
@@ -141,29 +305,33 @@ int main() {
         {22, bn::fixed_point(-116, 19), &bn::sprite_items::cactus1});
     items.push_back(
         {100, bn::fixed_point(-12, 23), &bn::sprite_items::sylvester});
-    items.push_back({125, bn::fixed_point(-35, 42), &bn::sprite_items::typist});
+    items.push_back(
+        {125, bn::fixed_point(-35, 42), &bn::sprite_items::typist, -40});
     return items;
   };
 
   bn::vector<WishlistItem, 16> wishlist = generate_wishlist();
-  bn::vector<bn::sprite_ptr, 16> upgrades;
+  // Upgrade sprites are only created once bought (see show_upgrade), so
+  // unowned items take no VRAM or OAM.
+  bn::vector<bn::optional<bn::sprite_ptr>, 16> upgrades;
   bn::vector<int, 16> prices;
   for (const WishlistItem& item : wishlist) {
     prices.push_back(item.price);
-    upgrades.push_back(item.sprite_item->create_sprite(item.pos));
+    upgrades.emplace_back();
   }
   bn::vector<bn::sprite_ptr, 8> popularity_bonuses;
 
-  for (bn::sprite_ptr sprite : upgrades) {
-    sprite.set_visible(false);
-  }
-  upgrades.at(8).set_z_order(-40);
-
   bn::music_items::wild_strawberry.play();
   bn::music::set_volume(1);
 
   bn::sound_items::bustle.play(0.1);
-  int bustle_timer = 0;
+
+#ifdef TI_PROFILER_ENABLED
+  // Compressed assets are unpacked while the scene is built and first
+  // committed, so time everything up to the first frame on screen. Compare
+  // with the unpacking budget in tests/asset_analyzer.h.
+  bn::optional<bn::timer> load_timer = bn::timer();
+#endif
 
   // map
   bn::regular_bg_ptr map = bn::regular_bg_items::bg1.create_bg(0, 0);
@@ -200,8 +368,26 @@ int main() {
   bn::sprite_ptr blocker = bn::sprite_items::blocker.create_sprite(58, 42);
   blocker.set_z_order(-40);
 
-  int timer = 40;
-  bn::random rng = bn::random();
+  ti::Rng rng =
+      ti::Rng::stream(ti::Rng::DEFAULT_SEED, ti::CrowdSim::SHARED_STREAM);
+
+  // Hold L while booting to record a session (L+R+B ends it), or R to
+  // replay the last recorded one. The global RNG and the customers' per-id
+  // streams are separate streams of the session seed, so the seed and the
+  // keys pressed fully determine a session.
+  INPUT_MODE input_mode = INPUT_MODE::LIVE;
+  if (bn::keypad::l_held()) {
+    session_log.clear(ti::Rng::DEFAULT_SEED);
+    input_mode = INPUT_MODE::RECORDING;
+  } else if (bn::keypad::r_held()) {
+    bn::sram::read_offset(session_log, INPUT_LOG_SRAM_OFFSET);
+    if (session_log.valid()) {
+      rng = ti::Rng::stream(session_log.seed(), ti::CrowdSim::SHARED_STREAM);
+      input_mode = INPUT_MODE::REPLAYING;
+    }
+  }
+  ti::InputReplay<INPUT_LOG_RUNS> replay(session_log);
+  ti::FrameInput input;
 
   // animation action
   bn::sprite_animate_action<7> steamAction =
@@ -211,10 +397,6 @@ int main() {
   bn::sprite_animate_action<5> drinkerAction =
       bn::create_sprite_animate_action_once(
           drinker, 15, bn::sprite_items::drinker.tiles_item(), 0, 0, 0, 0, 0);
-  bn::sprite_animate_action<10> sylvesterAction =
-      bn::create_sprite_animate_action_forever(
-          upgrades.at(7), 18, bn::sprite_items::sylvester.tiles_item(), 0, 1, 2,
-          3, 4, 5, 6, 7, 8, 9);
 
   bn::sprite_animate_action<5> pigeonAction =
       bn::create_sprite_animate_action_once(
@@ -237,231 +419,396 @@ int main() {
 
   // TODO: Add swallow mascot animation loop here if feature is enabled.
 
-  bn::sprite_animate_action<2> typistAction =
-      bn::create_sprite_animate_action_forever(
-          upgrades.at(8), 8, bn::sprite_items::typist.tiles_item(), 0, 1);
-
-  bn::sprite_animate_action<12> clockAction =
-      bn::create_sprite_animate_action_forever(
-          upgrades.at(0), 300, bn::sprite_items::clock.tiles_item(), 0, 1, 2, 3,
-          4, 5, 6, 7, 8, 9, 10, 11);
-
-  bn::deque<int, 8> order_queue = {};
-  bool waiting_spot = false;
-  bool purchased_this_frame = false;
-
-  bn::vector<ti::Person, 16> people;
-  people.push_back(ti::Person(ti::START::RIGHT, ti::TYPE::GREEN_SHIRT, 0));
-  people.push_back(ti::Person(ti::START::LEFT, ti::TYPE::GREEN_SHIRT, 1));
-  people.push_back(ti::Person(ti::START::RIGHT, ti::TYPE::GREEN_SHIRT, 2));
-  people.push_back(ti::Person(ti::START::LEFT, ti::TYPE::GREEN_SHIRT, 3));
-  people.push_back(ti::Person(ti::START::RIGHT, ti::TYPE::GREEN_SHIRT, 4));
-  people.push_back(ti::Person(ti::START::LEFT, ti::TYPE::GREEN_SHIRT, 5));
-  people.push_back(ti::Person(ti::START::RIGHT, ti::TYPE::GREEN_SHIRT, 6));
-  people.push_back(ti::Person(ti::START::LEFT, ti::TYPE::GREEN_SHIRT, 7));
-  people.push_back(ti::Person(ti::START::RIGHT, ti::TYPE::GREEN_SHIRT, 8));
-  people.push_back(ti::Person(ti::START::LEFT, ti::TYPE::GREEN_SHIRT, 9));
-
-  while (true) {
-    if (is_menu_shown) {
-      cursor.set_visible(true);
-      if (bn::keypad::up_pressed()) {
-        cursor_index = ti::move_cursor(cursor_index, -1, prices);
-      }
-      if (bn::keypad::down_pressed()) {
-        cursor_index = ti::move_cursor(cursor_index, +1, prices);
-      }
+  // Upgrade animations, created along with their sprites in show_upgrade().
+  bn::optional<bn::sprite_animate_action<10>> sylvesterAction;
+  bn::optional<bn::sprite_animate_action<2>> typistAction;
+  bn::optional<bn::sprite_animate_action<12>> clockAction;
+
+  // Every actor that rolls for something to do first wakes 41 frames in,
+  // staggered over one roll period so they don't all roll on the same frame,
+  // and the animations set up above all start out playing. Those bound to
+  // an upgrade stay suspended, rolls included, until show_upgrade() creates
+  // them.
+  ti::TimerWheel<AMBIENT_COUNT> ambient_wheel;
+  int first_rolls[int(AMBIENT::REFLECT)];
+  rng.get_ints(AMBIENT_ROLL_FRAMES, first_rolls, int(AMBIENT::REFLECT));
+  for (int actor = 0; actor < int(AMBIENT::REFLECT); ++actor) {
+    ambient_wheel.schedule(actor, 41 + first_rolls[actor]);
+  }
+  ambient_wheel.schedule(int(AMBIENT::BUSTLE), BUSTLE_FRAMES);
+  ti::AnimRegistry<AMBIENT_COUNT> animations;
+  for (AMBIENT actor :
+       {AMBIENT::STEAM, AMBIENT::DRINKER, AMBIENT::PIGEON, AMBIENT::PIGEON2,
+        AMBIENT::REFLECT, AMBIENT::TWINKLE}) {
+    animations.play(int(actor));
+  }
+  for (const UpgradeAnimation& bound : UPGRADE_ANIMATIONS) {
+    animations.set_visible(int(bound.actor), false);
+    ambient_wheel.cancel(int(bound.actor));
+  }
 
-      // Cursor shake effect
-      if (cursor_shake_frames_remaining > 0) {
-        bn::fixed_point orig_pos = get_cursor_pos(cursor_index);
-        cursor.set_position(bn::fixed_point(
-            orig_pos.x() + cursor_shake_direction * 2, orig_pos.y()));
-        cursor_shake_frames_remaining--;
-        cursor_shake_direction *= -1;
-        if (cursor_shake_frames_remaining == 0) {
-          cursor.set_position(orig_pos);
+  auto show_upgrade = [&](int index) {
+    const WishlistItem& item = wishlist.at(index);
+    bn::sprite_ptr sprite = item.sprite_item->create_sprite(item.pos);
+    sprite.set_z_order(item.z_order);
+    upgrades.at(index) = sprite;
+    for (const UpgradeAnimation& bound : UPGRADE_ANIMATIONS) {
+      if (bound.upgrade == index) {
+        switch (bound.actor) {
+          case AMBIENT::CLOCK:
+            clockAction = bn::create_sprite_animate_action_forever(
+                sprite, 300, bn::sprite_items::clock.tiles_item(), 0, 1, 2, 3,
+                4, 5, 6, 7, 8, 9, 10, 11);
+            break;
+          case AMBIENT::SYLVESTER:
+            sylvesterAction = bn::create_sprite_animate_action_forever(
+                sprite, 18, bn::sprite_items::sylvester.tiles_item(), 0, 1, 2,
+                3, 4, 5, 6, 7, 8, 9);
+            break;
+          case AMBIENT::TYPIST:
+            typistAction = bn::create_sprite_animate_action_forever(
+                sprite, 8, bn::sprite_items::typist.tiles_item(), 0, 1);
+            break;
+          default:
+            break;
         }
-      } else {
-        cursor.set_position(get_cursor_pos(cursor_index));
-      }
-      if (bn::keypad::a_pressed()) {
-        const int selected_price = prices.at(cursor_index);
-        if (selected_price > 0 && selected_price <= cash) {
-          cash = cash - selected_price;
-          upgrades.at(cursor_index)
-              .set_visible(!upgrades.at(cursor_index).visible());
-          prices.at(cursor_index) = 0;
-          redraw_wishlist(text_generator, text_sprites, prices);
-          popularity_level = popularity_level + 1;
-          popularity_bar.set_item(bn::sprite_items::popularity_bar,
-                                  popularity_level);
-          is_menu_shown = false;
-          menu_background.set_visible(false);
-          text_sprites.clear();
-          twinkle.set_position(upgrades.at(cursor_index).position());
-          twinkle.set_visible(true);
-          bn::sound_items::sparkle.play(0.8);
-          twinkle_action = bn::create_sprite_animate_action_once(
-              twinkle, 6, bn::sprite_items::twinkle.tiles_item(), 0, 1, 2, 3, 4,
-              5, 6, 7, 8, 9, 10);
-        } else if (selected_price > 0 && selected_price > cash) {
-          cursor_shake_frames_remaining = 10;
-          cursor_shake_direction = 1;
-          bn::sound_items::cancel.play(1.0);
-        }
-      }
-    } else {
-      cursor.set_visible(false);
-      if (bn::keypad::a_pressed()) {
-        if (!is_menu_shown) {
-          cursor_index = 0;
-          for (int i = 0; i < prices.size(); ++i) {
-            if (prices.at(i) > 0) {
-              cursor_index = i;
-              break;
-            }
-          }
-          is_menu_shown = true;
-          menu_background.set_visible(true);
-          redraw_wishlist(text_generator, text_sprites, prices);
+        animations.play(int(bound.actor));
+        animations.set_visible(int(bound.actor), true);
+        if (bound.actor < AMBIENT::REFLECT) {
+          ambient_wheel.schedule(int(bound.actor), AMBIENT_ROLL_FRAMES);
         }
       }
     }
+  };
 
-    if (bn::keypad::b_pressed() && is_menu_shown) {
-      is_menu_shown = false;
-      menu_background.set_visible(false);
-      text_sprites.clear();
+#ifdef TI_PROFILER_ENABLED
+  bn::vector<bn::sprite_ptr, 56> profiler_sprites;
+  bool profiler_overlay_shown = false;
+#endif
+
+  // Customers only exist once popularity lets them in: their simulation,
+  // sprites and tiles are created on demand, up to CrowdSim::MAX_PEOPLE.
+  ti::CrowdSim crowd(ti::OrderQueue::DEFAULT_LENGTH,
+                     input_mode == INPUT_MODE::LIVE ? ti::Rng::DEFAULT_SEED
+                                                    : session_log.seed());
+  bn::vector<ti::Person, ti::CrowdSim::MAX_PEOPLE> people;
+  auto admit_customers = [&]() {
+    while (crowd.people().size() < popularity_level &&
+           !crowd.people().full()) {
+      const int id = crowd.people().size();
+      const ti::PersonSim& sim =
+          crowd.add_person(id % 2 == 0 ? ti::START::RIGHT : ti::START::LEFT,
+                           ti::TYPE::GREEN_SHIRT);
+      people.push_back(ti::Person(sim, crowd.tick()));
     }
+  };
 
-    if (true) {
-      cash_text_sprites.clear();
-      text_generator.set_palette_item(
-          bn::sprite_palette_items::white_text_palette);
-      text_generator.set_right_alignment();
-      text_generator.generate(-21, -71, "$" + bn::to_string<8>(cash),
-                              cash_text_sprites);
-      text_generator.set_palette_item(
-          bn::sprite_palette_items::black_text_palette);
+  // Restore progress and credit the time away in closed form. Recorded and
+  // replayed sessions always start from a fresh cafe and never save.
+  const bool saving_enabled = input_mode == INPUT_MODE::LIVE;
+  if (saving_enabled) {
+    ti::SaveData save;
+    bn::sram::read_offset(save, SAVE_SRAM_OFFSET);
+    if (save.valid()) {
+      cash = save.cash;
+      for (int i = 0; i < prices.size(); ++i) {
+        if (save.bought & (1u << i)) {
+          show_upgrade(i);
+          prices.at(i) = 0;
+          popularity_level = popularity_level + 1;
+        }
+      }
+      popularity_bar.set_item(bn::sprite_items::popularity_bar,
+                              popularity_bar_frame(popularity_level));
+      admit_customers();
+
+      ti::EconomyModel economy;
+      for (int i = 0; i < popularity_level && i < crowd.people().size(); ++i) {
+        economy.add_customer(crowd.people().at(i).get_speed());
+      }
+      const ti::Earnings away =
+          economy.earnings(save.seconds_away(read_clock()));
+      cash = ti::add_cash(cash, away.cash);
     }
+  }
+  admit_customers();
 
-    if (bustle_timer > 60 * 29) {
-      bustle_timer = 0;
-      bn::sound_items::bustle.play(0.1 + bn::fixed(popularity_level) / 20);
-    } else {
-      bustle_timer = bustle_timer + 1;
+  auto save_progress = [&]() {
+    if (!saving_enabled) {
+      return;
     }
-    timer = timer - 1;
-    if (timer < 0) {
-      if (chance(rng, 39)) {
-        barista.set_item(bn::sprite_items::barista, rng.get_int(5));
-      }
-      if (chance(rng, 39)) {
-        till.set_item(bn::sprite_items::till, rng.get_int(3));
+    ti::SaveData save;
+    save.cash = cash;
+    for (int i = 0; i < prices.size(); ++i) {
+      if (prices.at(i) == 0) {
+        save.bought |= 1u << i;
       }
-      if (chance(rng, 7)) {
-        if (steamAction.done()) {
+    }
+    save.saved_at = read_clock();
+    bn::sram::write_offset(save, SAVE_SRAM_OFFSET);
+  };
+  int frames_until_autosave = AUTOSAVE_FRAMES;
+
+  // Ambient actors: what an actor does when it wakes, and one animation
+  // step while it animates (returning true once the animation is done).
+  auto wake = [&](AMBIENT actor) {
+    switch (actor) {
+      case AMBIENT::BARISTA:
+        if (chance(rng, 39)) {
+          barista.set_item(bn::sprite_items::barista, rng.get_int(5));
+        }
+        break;
+      case AMBIENT::TILL:
+        if (chance(rng, 39)) {
+          till.set_item(bn::sprite_items::till, rng.get_int(3));
+        }
+        break;
+      case AMBIENT::STEAM:
+        if (chance(rng, 7) && steamAction.done()) {
           bn::sound_items::steam.play(0.6);
           steamAction = bn::create_sprite_animate_action_once(
               steam, 5, bn::sprite_items::steam.tiles_item(), 0, 1, 2, 3, 4, 5,
               6);
           steam.set_visible(true);
+          animations.play(int(AMBIENT::STEAM));
         }
-      }
-      if (chance(rng, 9)) {
-        if (drinkerAction.done()) {
+        break;
+      case AMBIENT::DRINKER:
+        if (chance(rng, 9) && drinkerAction.done()) {
           drinkerAction = bn::create_sprite_animate_action_once(
               drinker, 15, bn::sprite_items::drinker.tiles_item(), 0, 1, 2, 1,
               0);
+          animations.play(int(AMBIENT::DRINKER));
         }
-      }
-      if (chance(rng, 90)) {
-        talkative.set_item(bn::sprite_items::talkative, rng.get_int(4));
-      }
-
-      if (typistAction.done()) {
-        if (chance(rng, 19)) {
-          typistAction = bn::create_sprite_animate_action_forever(
-              upgrades.at(8), 8, bn::sprite_items::typist.tiles_item(), 0, 1);
+        break;
+      case AMBIENT::TALKATIVE:
+        if (chance(rng, 90)) {
+          talkative.set_item(bn::sprite_items::talkative, rng.get_int(4));
         }
-      } else {
-        if (chance(rng, 19)) {
+        break;
+      case AMBIENT::TYPIST:
+        // Only scheduled once the typist is bought, so the action exists.
+        if (typistAction->done()) {
+          if (chance(rng, 19)) {
+            typistAction = bn::create_sprite_animate_action_forever(
+                *upgrades.at(8), 8, bn::sprite_items::typist.tiles_item(), 0,
+                1);
+            animations.play(int(AMBIENT::TYPIST));
+          }
+        } else if (chance(rng, 19)) {
           typistAction = bn::create_sprite_animate_action_once(
-              upgrades.at(8), 8, bn::sprite_items::typist.tiles_item(), 2, 2);
+              *upgrades.at(8), 8, bn::sprite_items::typist.tiles_item(), 2, 2);
         }
-      }
-
-      if (chance(rng, 19)) {
-        if (pigeonAction.done()) {
+        break;
+      case AMBIENT::PIGEON:
+        if (chance(rng, 19) && pigeonAction.done()) {
           pigeonAction = bn::create_sprite_animate_action_once(
               pigeon, 15, bn::sprite_items::pigeon.tiles_item(), 0, 1, 0, 1, 0);
+          animations.play(int(AMBIENT::PIGEON));
         }
-      }
-      if (chance(rng, 20)) {
-        if (pigeon2Action.done()) {
+        break;
+      case AMBIENT::PIGEON2:
+        if (chance(rng, 20) && pigeon2Action.done()) {
           pigeon2Action = bn::create_sprite_animate_action_once(
               pigeon2, 15, bn::sprite_items::pigeon2.tiles_item(), 0, 1, 0, 1,
               0);
+          animations.play(int(AMBIENT::PIGEON2));
         }
-      }
-      // TODO: Swallow mascot random jump logic (uncomment if swallow is
-      // re-enabled)
-
-      timer = 30;
-    }
-
-    // TODO: Swallow mascot movement logic (uncomment if swallow is re-enabled)
-
-    if (!twinkle_action.done()) {
-      twinkle_action.update();
-    }
-    if (!steamAction.done()) {
-      steamAction.update();
-    }
-    if (!drinkerAction.done()) {
-      drinkerAction.update();
-    }
-    if (!reflectAction1.done()) {
-      reflectAction1.update();
-      // TODO: Update reflectAction2 animation if feature is added.
-    } else {
-      if (chance(rng, 1, 1000)) {
+        break;
+      case AMBIENT::REFLECT:
         reflectAction1 = bn::create_sprite_animate_action_once(
             reflect1, 4, bn::sprite_items::reflect.tiles_item(), 0, 1, 2, 3, 4,
             5, 6, 7, 8, 9, 10, 11, 12, 13, 14);
-        // TODO: (Optional) Restart reflectAction2 as part of polish animation.
-      }
+        // TODO: (Optional) Restart reflectAction2 as part of polish
+        // animation.
+        animations.play(int(AMBIENT::REFLECT));
+        return;
+      case AMBIENT::BUSTLE:
+        // As loud as the popularity bar shows, so at most 0.6.
+        bn::sound_items::bustle.play(
+            0.1 + bn::fixed(popularity_bar_frame(popularity_level)) / 20);
+        ambient_wheel.schedule(int(actor), BUSTLE_FRAMES);
+        return;
+      default:
+        return;
     }
-    if (!pigeonAction.done()) {
-      pigeonAction.update();
+    // TODO: Swallow mascot random jump logic (add a SWALLOW actor if the
+    // swallow is re-enabled)
+    ambient_wheel.schedule(int(actor), AMBIENT_ROLL_FRAMES);
+  };
+
+  auto animate = [&](AMBIENT actor) -> bool {
+    switch (actor) {
+      case AMBIENT::STEAM:
+        return step_animation(steamAction);
+      case AMBIENT::DRINKER:
+        return step_animation(drinkerAction);
+      case AMBIENT::TYPIST:
+        return step_animation(*typistAction);
+      case AMBIENT::PIGEON:
+        return step_animation(pigeonAction);
+      case AMBIENT::PIGEON2:
+        return step_animation(pigeon2Action);
+      case AMBIENT::REFLECT:
+        // TODO: Update reflectAction2 animation if feature is added.
+        if (step_animation(reflectAction1)) {
+          // Used to be a 1 in 1000 roll every frame; same average wait.
+          ambient_wheel.schedule(int(actor),
+                                 1 + rng.get_int(2 * REFLECT_MEAN_FRAMES));
+          return true;
+        }
+        return false;
+      case AMBIENT::SYLVESTER:
+        return step_animation(*sylvesterAction);
+      case AMBIENT::CLOCK:
+        return step_animation(*clockAction);
+      case AMBIENT::TWINKLE:
+        return step_animation(twinkle_action);
+      default:
+        return true;
     }
-    if (!pigeon2Action.done()) {
-      pigeon2Action.update();
+  };
+
+  // One fixed simulation step: crowd, economy, timers and ambient
+  // animations. Turbo runs several per displayed frame; everything that
+  // only changes what is drawn stays in the loop below, once per frame.
+  auto sim_tick = [&]() {
+    {
+      TI_PROFILE_SCOPE(ti::PROFILE_ZONE::AMBIENT);
+      // Only actors that are due or animating, and not hidden, are touched.
+      ambient_wheel.advance(
+          [&](int actor) { wake(static_cast<AMBIENT>(actor)); });
+      animations.step(
+          [&](int actor) { return animate(static_cast<AMBIENT>(actor)); });
+      // TODO: Swallow mascot movement logic (uncomment if swallow is
+      // re-enabled)
     }
-    // TODO: Update swallow animation if mascot feature enabled.
-    sylvesterAction.update();
-    if (!typistAction.done()) {
-      typistAction.update();
+    bool purchased = false;
+    {
+      TI_PROFILE_SCOPE(ti::PROFILE_ZONE::CROWD);
+      purchased = crowd.update(popularity_level);
     }
-    bn::vector<int, 16> types;
-    for (int i = 0; i < 14; i++) {
-      types.push_back(i);
+
+    if (purchased) {
+      cash = ti::add_cash(cash, ti::PURCHASE_PAYOUT_MIN +
+                                    rng.get_int(ti::PURCHASE_PAYOUT_SPREAD));
+      cash_sprite.set_visible(true);
+      bn::sound_items::cash.play(0.8);
     }
-    for (int i = 0; i < popularity_level; i++) {
-      for (int j = 0; j < types.size(); j++) {
-        if ((int)people.at(i).get_type() == types.at(j)) {
-          types.erase(types.begin() + j);
+    rng.get();
+  };
+
+  while (true) {
+    {
+      TI_PROFILE_SCOPE(ti::PROFILE_ZONE::INPUT);
+      unsigned short keys = read_keypad();
+      if (input_mode == INPUT_MODE::REPLAYING && !replay.next(keys)) {
+        input_mode = INPUT_MODE::LIVE;
+      } else if (input_mode == INPUT_MODE::RECORDING) {
+        // Not SELECT or START: profile builds use those for the overlay.
+        constexpr unsigned short stop_keys = ti::KEY_L | ti::KEY_R | ti::KEY_B;
+        if ((keys & stop_keys) == stop_keys || !session_log.record(keys)) {
+          bn::sram::write_offset(session_log, INPUT_LOG_SRAM_OFFSET);
+          input_mode = INPUT_MODE::LIVE;
+        }
+      }
+      input.update(keys);
+
+      if (is_menu_shown) {
+        cursor.set_visible(true);
+        if (input.pressed(ti::KEY_UP)) {
+          cursor_index = ti::move_cursor(cursor_index, -1, prices);
+        }
+        if (input.pressed(ti::KEY_DOWN)) {
+          cursor_index = ti::move_cursor(cursor_index, +1, prices);
+        }
+
+        // Cursor shake effect
+        if (cursor_shake_frames_remaining > 0) {
+          bn::fixed_point orig_pos = get_cursor_pos(cursor_index);
+          cursor.set_position(bn::fixed_point(
+              orig_pos.x() + cursor_shake_direction * 2, orig_pos.y()));
+          cursor_shake_frames_remaining--;
+          cursor_shake_direction *= -1;
+          if (cursor_shake_frames_remaining == 0) {
+            cursor.set_position(orig_pos);
+          }
+        } else {
+          cursor.set_position(get_cursor_pos(cursor_index));
+        }
+        if (input.pressed(ti::KEY_A)) {
+          const int selected_price = prices.at(cursor_index);
+          if (selected_price > 0 && selected_price <= cash) {
+            cash = cash - selected_price;
+            show_upgrade(cursor_index);
+            prices.at(cursor_index) = 0;
+            redraw_wishlist(text_generator, text_sprites, prices);
+            popularity_level = popularity_level + 1;
+            popularity_bar.set_item(bn::sprite_items::popularity_bar,
+                                    popularity_bar_frame(popularity_level));
+            admit_customers();
+            is_menu_shown = false;
+            menu_background.set_visible(false);
+            text_sprites.clear();
+            twinkle.set_position(wishlist.at(cursor_index).pos);
+            twinkle.set_visible(true);
+            bn::sound_items::sparkle.play(0.8);
+            save_progress();
+            twinkle_action = bn::create_sprite_animate_action_once(
+                twinkle, 6, bn::sprite_items::twinkle.tiles_item(), 0, 1, 2, 3,
+                4, 5, 6, 7, 8, 9, 10);
+            animations.play(int(AMBIENT::TWINKLE));
+          } else if (selected_price > 0 && selected_price > cash) {
+            cursor_shake_frames_remaining = 10;
+            cursor_shake_direction = 1;
+            bn::sound_items::cancel.play(1.0);
+          }
+        }
+      } else {
+        cursor.set_visible(false);
+        if (input.pressed(ti::KEY_A)) {
+          if (!is_menu_shown) {
+            cursor_index = 0;
+            for (int i = 0; i < prices.size(); ++i) {
+              if (prices.at(i) > 0) {
+                cursor_index = i;
+                break;
+              }
+            }
+            is_menu_shown = true;
+            menu_background.set_visible(true);
+            redraw_wishlist(text_generator, text_sprites, prices);
+          }
         }
       }
+
+      if (input.pressed(ti::KEY_B) && is_menu_shown) {
+        is_menu_shown = false;
+        menu_background.set_visible(false);
+        text_sprites.clear();
+      }
+    }
+
+    {
+      TI_PROFILE_SCOPE(ti::PROFILE_ZONE::SIM);
+      const int ticks = sim_ticks_per_frame(input);
+      for (int tick = 0; tick < ticks; ++tick) {
+        sim_tick();
+      }
+    }
+
+    {
+      TI_PROFILE_SCOPE(ti::PROFILE_ZONE::HUD);
+      cash_hud.set_value(cash);
     }
-    for (int i = 0; i < people.size(); i++) {
-      if (popularity_level > i) {
-        people.at(i).update(order_queue, waiting_spot, purchased_this_frame,
-                            types);
+    {
+      TI_PROFILE_SCOPE(ti::PROFILE_ZONE::PEOPLE);
+      // Inactive customers wait offscreen, so their views start out hidden
+      // and are never touched; active ones hide themselves while offscreen.
+      for (int i = 0; i < people.size() && i < popularity_level; i++) {
+        people.at(i).update(crowd.people().at(i), crowd.tick());
       }
     }
-    clockAction.update();
 
     if (cash_sprite.visible()) {
       cash_sprite.set_y(cash_sprite.y() - 0.2);
@@ -470,14 +817,32 @@ int main() {
         cash_sprite.set_y(-7);
       }
     }
-
-    if (purchased_this_frame) {
-      cash += rng.get_int(3) + 3;
-      cash_sprite.set_visible(true);
-      bn::sound_items::cash.play(0.8);
-      purchased_this_frame = false;
+    if (--frames_until_autosave == 0) {
+      frames_until_autosave = AUTOSAVE_FRAMES;
+      save_progress();
+    }
+#ifdef TI_PROFILER_ENABLED
+    update_profiler_overlay(input, text_generator, profiler_sprites,
+                            profiler_overlay_shown);
+#endif
+    {
+      TI_PROFILE_SCOPE(ti::PROFILE_ZONE::CORE);
+      bn::core::update();
+    }
+#ifdef TI_PROFILER_ENABLED
+    if (load_timer) {
+      BN_LOG("load ", load_timer->elapsed_ticks(), " ticks, ",
+             bn::timers::ticks_per_frame(), " per frame");
+      load_timer.reset();
+    }
+#endif
+    {
+      // Straight after the commit, so customers' new frames are in VRAM
+      // before the screen starts drawing them.
+      TI_PROFILE_SCOPE(ti::PROFILE_ZONE::TILES);
+      for (int i = 0; i < people.size() && i < popularity_level; i++) {
+        people.at(i).upload_frame();
+      }
     }
-    bn::core::update();
-    rng.get();
   }
-}
+}
\ No newline at end of file
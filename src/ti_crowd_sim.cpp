@@ -0,0 +1,46 @@
+/**
+ * @file ti_crowd_sim.cpp
+ * @brief Implements CrowdSim (see ti_crowd_sim.h).
+ */
+
+#include "ti_crowd_sim.h"
+
+namespace ti {
+
+PersonSim& CrowdSim::add_person(START start, TYPE type) {
+  _people.push_back(PersonSim(start, type, _people.size(), _seed));
+  return _people.back();
+}
+
+bool CrowdSim::update(int active_count) {
+  ++_tick;
+  if (active_count > _people.size()) {
+    active_count = _people.size();
+  }
+
+  // Customers entering or leaving play claim or return their style; the pool
+  // is otherwise kept up to date by respawns.
+  while (_styled_count < active_count) {
+    PersonSim& person = _people.at(_styled_count);
+    // With every look taken, a newcomer dressed in another borrows the look
+    // of the last customer in play.
+    if (_styles.is_free(static_cast<int>(person.get_type())) &&
+        !_styles.can_wear_another()) {
+      person.set_type(_people.at(_styled_count - 1).get_type());
+    }
+    _styles.acquire(static_cast<int>(person.get_type()));
+    ++_styled_count;
+  }
+  while (_styled_count > active_count) {
+    _styles.release(static_cast<int>(_people.at(--_styled_count).get_type()));
+  }
+
+  bool purchased_this_frame = false;
+  for (int i = 0; i < active_count; i++) {
+    _people.at(i).update(_order_queue, _waiting_spot, purchased_this_frame,
+                         _styles, _active_loiterers);
+  }
+  return purchased_this_frame;
+}
+
+}  // namespace ti
@@ -0,0 +1,143 @@
+/**
+ * @file ti_economy.cpp
+ * @brief Implements EconomyModel (see ti_economy.h).
+ *
+ * All arithmetic is integer (Q12 where fractions matter), so the GBA and the
+ * host tests agree exactly on what an interval is worth.
+ */
+
+#include "ti_economy.h"
+
+#include "ti_cafe_layout.h"
+#include "ti_helpers.h"
+#include "ti_order_queue.h"
+#include "ti_person_sim.h"
+
+namespace ti {
+
+namespace {
+constexpr int MAX_INT = 0x7fffffff;
+
+// Frames PersonSim::_advance_to takes to walk a leg, arrival frame included.
+long long leg_frames(const bn::fixed_point& from, const bn::fixed_point& to,
+                     bn::fixed speed) {
+  return count_steps_to(from, to, get_step_vector(from, to, speed)) + 1;
+}
+
+int clamp_to_int(long long value) {
+  return value > MAX_INT ? MAX_INT : int(value);
+}
+}  // namespace
+
+int EconomyModel::visit_frames(bn::fixed speed) {
+  const CafeLayout& cafe = CAFE_LAYOUT;
+
+  // Inside: door, queue, till, one of the two counters, and back out.
+  long long inside_q12 =
+      (leg_frames(cafe.outside, cafe.door, speed) +
+       leg_frames(cafe.door, cafe.queue_start, speed) +
+       leg_frames(cafe.queue_start, cafe.queue_front, speed) +
+       leg_frames(cafe.door, cafe.outside, speed))
+      << 12;
+  inside_q12 += (leg_frames(cafe.queue_front, cafe.counter1, speed) +
+                 leg_frames(cafe.queue_front, cafe.counter2, speed) +
+                 leg_frames(cafe.counter1, cafe.door, speed) +
+                 leg_frames(cafe.counter2, cafe.door, speed))
+                << 11;
+
+  // Street: out to either edge and back, then as many walk-bys as it takes
+  // to come in. Someone who came from the left walks by to the right edge,
+  // and the other way round, so the expected detours solve a 2x2 system.
+  const long long left = leg_frames(cafe.outside, cafe.left, speed) +
+                         leg_frames(cafe.left, cafe.outside, speed);
+  const long long right = leg_frames(cafe.outside, cafe.right, speed) +
+                          leg_frames(cafe.right, cafe.outside, speed);
+  const int left_odds = PersonSim::EXIT_LEFT_ODDS;
+  const int right_odds = 10 - left_odds;
+  const long long street_q12 = ((left * left_odds + right * right_odds) << 12) /
+                               10;
+  const long long chance = PersonSim::WALK_BY_CHANCE;
+  const long long detour_q12 =
+      ((left_odds * (chance * right + left) +
+        right_odds * (chance * left + right))
+       << 12) /
+      (10 * (chance * chance - 1));
+
+  // Ordering and pick-up waits (see _handle_ordering and _handle_waiting),
+  // plus one loiter on the street, which nearly every visit gets to.
+  const long long waits = (PersonSim::WAIT_MAX + 1) +
+                          (PersonSim::WAIT_MAX + 61);
+  const long long loiter_q12 =
+      ((2 * PersonSim::LOITER_SECONDS_MIN +
+        PersonSim::LOITER_SECONDS_SPREAD - 1) *
+       FRAMES_PER_SECOND)
+      << 11;
+
+  const long long total_q12 =
+      inside_q12 + street_q12 + detour_q12 + (waits << 12) + loiter_q12;
+  return int((total_q12 + 2048) >> 12);
+}
+
+int EconomyModel::service_frames(bn::fixed speed) {
+  // The order itself, then the next customer stepping up to the till.
+  return PersonSim::WAIT_MAX + 1 +
+         int(leg_frames(OrderQueue::slot_position(1),
+                        OrderQueue::slot_position(0), speed)) +
+         1;
+}
+
+void EconomyModel::add_customer(bn::fixed speed) {
+  ++_customers;
+  _speed_total += speed;
+  _visits_per_hour_q12 +=
+      (static_cast<long long>(FRAMES_PER_HOUR) << 12) / visit_frames(speed);
+}
+
+long long EconomyModel::purchases_per_hour_q12() const {
+  if (_customers == 0) {
+    return 0;
+  }
+
+  // Closed loop of "customers", each spending "think" frames away from the
+  // till per visit and "service" frames at it. Mean value analysis adds one
+  // customer at a time: an arrival finds the line as it was with one fewer
+  // customer, waits a full order for everyone queued and half of one for
+  // whoever is being served (orders take a fixed time). Unlike an open
+  // queue, the line can never hold more customers than are in play, which
+  // matters once the till is busy. Rates are per frame in Q24, the rest Q12.
+  const long long service = service_frames(_speed_total / _customers);
+  const long long visit = (static_cast<long long>(_customers) *
+                           FRAMES_PER_HOUR << 12) /
+                          _visits_per_hour_q12;
+  const long long think_q12 = visit > service ? (visit - service) << 12 : 0;
+  long long rate_q24 = 0;
+  long long queued_q12 = 0;
+  long long busy_q12 = 0;
+  for (long long customers = 1; customers <= _customers; ++customers) {
+    const long long response_q12 = (service << 12) +
+                                   (queued_q12 - busy_q12) * service +
+                                   busy_q12 * service / 2;
+    rate_q24 = (customers << 36) / (think_q12 + response_q12);
+    if (rate_q24 > (1LL << 24) / service) {
+      rate_q24 = (1LL << 24) / service;  // the till can't go any faster
+    }
+    queued_q12 = (rate_q24 * response_q12) >> 24;
+    busy_q12 = (rate_q24 * service) >> 12;
+  }
+  return (rate_q24 * FRAMES_PER_HOUR) >> 12;
+}
+
+Earnings EconomyModel::earnings(long long seconds) const {
+  if (seconds <= 0) {
+    return Earnings();
+  }
+  const long long customers =
+      purchases_per_hour_q12() * seconds / (3600LL << 12);
+  Earnings result;
+  result.customers = clamp_to_int(customers);
+  result.cash = clamp_to_int(
+      customers * (2 * PURCHASE_PAYOUT_MIN + PURCHASE_PAYOUT_SPREAD - 1) / 2);
+  return result;
+}
+
+}  // namespace ti
@@ -10,20 +10,119 @@
 
 namespace ti {
 
+namespace {
+
+// Slope resolution of the direction table: headings are quantized to
+// atan(k / DIRECTION_STEPS), i.e. at most ~0.11 degrees off.
+constexpr int DIRECTION_STEPS = 256;
+
+/**
+ * Unit vectors (Q12, same scale as bn::fixed) for the first octant. Entry k
+ * is the direction of (DIRECTION_STEPS, k): "along" is the major-axis
+ * component, "across" the minor one.
+ */
+struct DirectionTable {
+  short along[DIRECTION_STEPS + 1];
+  short across[DIRECTION_STEPS + 1];
+};
+
+constexpr long long isqrt(long long value) {
+  long long root = value;
+  long long next = (root + 1) / 2;
+  while (next < root) {
+    root = next;
+    next = (root + value / root) / 2;
+  }
+  return root;
+}
+
+constexpr DirectionTable make_direction_table() {
+  DirectionTable table = {};
+  for (int k = 0; k <= DIRECTION_STEPS; ++k) {
+    long long length_sq = (long long)DIRECTION_STEPS * DIRECTION_STEPS + k * k;
+    // length * 65536, so the quotients below land on the Q12 scale.
+    long long length = isqrt(length_sq << 32);
+    table.along[k] = short((4096LL * DIRECTION_STEPS * 65536 + length / 2) /
+                           length);
+    table.across[k] = short((4096LL * k * 65536 + length / 2) / length);
+  }
+  return table;
+}
+
+constexpr DirectionTable DIRECTIONS = make_direction_table();
+
+static_assert(DIRECTIONS.along[0] == 4096 && DIRECTIONS.across[0] == 0,
+              "Direction table must start on the major axis.");
+static_assert(DIRECTIONS.along[DIRECTION_STEPS] ==
+                  DIRECTIONS.across[DIRECTION_STEPS],
+              "Direction table must end on the diagonal.");
+
+// Steps of size "step" before "distance" is within the snap range on one axis.
+int axis_steps(bn::fixed distance, bn::fixed step) {
+  bn::fixed remaining = bn::abs(distance) - 2;
+  bn::fixed speed = bn::abs(step);
+  if (remaining <= 0 || speed <= 0) {
+    return 0;
+  }
+  int steps = (remaining / speed).integer();
+  if (speed * steps < remaining) {
+    ++steps;
+  }
+  return steps;
+}
+
+}  // namespace
+
+bn::fixed_point get_step_vector(const bn::fixed_point& from,
+                                const bn::fixed_point& to, bn::fixed speed) {
+  int dx = (to.x() - from.x()).integer();
+  int dy = (to.y() - from.y()).integer();
+  int abs_x = dx < 0 ? -dx : dx;
+  int abs_y = dy < 0 ? -dy : dy;
+  if (abs_x == 0 && abs_y == 0) {
+    return bn::fixed_point(0, 0);
+  }
+
+  bool steep = abs_y > abs_x;
+  int major = steep ? abs_y : abs_x;
+  int minor = steep ? abs_x : abs_y;
+  int index = (minor * DIRECTION_STEPS + major / 2) / major;
+
+  int unit_x = steep ? DIRECTIONS.across[index] : DIRECTIONS.along[index];
+  int unit_y = steep ? DIRECTIONS.along[index] : DIRECTIONS.across[index];
+  if (dx < 0) unit_x = -unit_x;
+  if (dy < 0) unit_y = -unit_y;
+
+  return bn::fixed_point(speed * bn::fixed::from_data(unit_x),
+                         speed * bn::fixed::from_data(unit_y));
+}
+
 bn::fixed_point get_next_step(const bn::fixed_point& from,
                               const bn::fixed_point& to, bn::fixed speed) {
   bn::fixed diff_x = from.x() - to.x();
   bn::fixed diff_y = from.y() - to.y();
 
   if (bn::abs(diff_x) > 2 || bn::abs(diff_y) > 2) {
-    bn::fixed angle = bn::degrees_atan2(diff_y.integer(), diff_x.integer());
-    bn::pair<bn::fixed, bn::fixed> xy = bn::degrees_sin_and_cos(angle);
-
-    return bn::fixed_point(from.x() - speed * xy.second,
-                           from.y() - speed * xy.first);
+    bn::fixed_point step = get_step_vector(from, to, speed);
+    return bn::fixed_point(from.x() + step.x(), from.y() + step.y());
   }
 
   return to;
 }
 
+int count_steps_to(const bn::fixed_point& from, const bn::fixed_point& to,
+                   const bn::fixed_point& step) {
+  int steps_x = axis_steps(to.x() - from.x(), step.x());
+  int steps_y = axis_steps(to.y() - from.y(), step.y());
+  return steps_x > steps_y ? steps_x : steps_y;
+}
+
+bool is_offscreen(const bn::fixed_point& center, int half_width,
+                  int half_height) {
+  constexpr int HALF_SCREEN_WIDTH = 120;
+  constexpr int HALF_SCREEN_HEIGHT = 80;
+  return bn::abs(center.x()) >= HALF_SCREEN_WIDTH + half_width ||
+         bn::abs(center.y()) >= HALF_SCREEN_HEIGHT + half_height;
+}
+
 }  // namespace ti
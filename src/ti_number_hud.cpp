@@ -0,0 +1,55 @@
+/**
+ * @file ti_number_hud.cpp
+ * @brief Implements NumberHud (see ti_number_hud.h).
+ */
+
+#include "ti_number_hud.h"
+
+#include "bn_sprite_builder.h"
+#include "ti_font.h"
+
+namespace ti {
+
+NumberHud::NumberHud(int right_x, int y,
+                     const bn::sprite_palette_item& palette, char prefix)
+    : _glyphs(prefix), _right_x(right_x) {
+  for (int slot = 0; slot < SLOTS; ++slot) {
+    bn::sprite_builder builder(bn::sprite_items::font);
+    builder.set_position(right_x, y);
+    builder.set_bg_priority(0);
+    builder.set_visible(false);
+    bn::sprite_ptr sprite = builder.release_build();
+    sprite.set_palette(palette);
+    _sprites.push_back(sprite);
+  }
+}
+
+void NumberHud::set_value(int value) {
+  unsigned changed = _glyphs.set_value(value);
+  if (!changed) {
+    return;
+  }
+
+  // Walk right to left so each glyph's left edge is the running pen position.
+  int pen = _right_x;
+  for (int slot = 0; slot < SLOTS; ++slot) {
+    bn::sprite_ptr& sprite = _sprites[slot];
+    bool slot_changed = changed & (1u << slot);
+    if (slot >= _glyphs.length()) {
+      if (slot_changed) {
+        sprite.set_visible(false);
+      }
+      continue;
+    }
+
+    int index = _glyphs.glyph(slot) - ' ';
+    pen -= variable_8x8_sprite_font_character_widths[index];
+    if (slot_changed) {
+      sprite.set_tiles(bn::sprite_items::font.tiles_item(), index);
+      sprite.set_visible(true);
+    }
+    sprite.set_x(pen + 4);
+  }
+}
+
+}  // namespace ti
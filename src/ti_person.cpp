@@ -1,53 +1,56 @@
 /**
  * @file ti_person.cpp
- * @brief Implements the Person class state/behavior for customers in the jam
- * cafe game.
+ * @brief Implements the Person view for customers in the jam cafe game.
  *
- * Contains core state machine logic, sprite animation switching, queue/ordering
- * workflow, and all per-customer lifecycle management for the main gameplay
- * flow.
- *
- * Agent/Contributor notes:
- *   - This file is tightly coupled with the game balance and overall tempo.
- *   - Magic numbers and queue-related quirks are a legacy from the rapid game
- * jam build.
- *   - If making changes, test thoroughly in-emulator, as small tweaks have
- * game-wide effects!
+ * Sprite creation, style (palette) switching, animation playback and frame
+ * streaming for a customer. Behavior belongs in ti_person_sim.cpp; this file
+ * only reacts to what the simulation reports.
  */
 
 #include "ti_person.h"
 
-#include "bn_log.h"
-#include "bn_math.h"
+#include "bn_memory.h"
 #include "bn_sprite_builder.h"
 #include "bn_sprite_items_shadow.h"
-#include "bn_sprite_items_walk1.h"
-#include "bn_sprite_items_walk10.h"
-#include "bn_sprite_items_walk11.h"
-#include "bn_sprite_items_walk12.h"
-#include "bn_sprite_items_walk13.h"
-#include "bn_sprite_items_walk14.h"
-#include "bn_sprite_items_walk2.h"
-#include "bn_sprite_items_walk3.h"
-#include "bn_sprite_items_walk4.h"
-#include "bn_sprite_items_walk5.h"
-#include "bn_sprite_items_walk6.h"
-#include "bn_sprite_items_walk7.h"
-#include "bn_sprite_items_walk8.h"
-#include "bn_sprite_items_walk9.h"
+#include "bn_sprite_items_customer_body_a.h"
+#include "bn_sprite_items_customer_body_b.h"
+#include "bn_sprite_items_customer_body_c.h"
+#include "bn_sprite_palette_items_customer_look1.h"
+#include "bn_sprite_palette_items_customer_look10.h"
+#include "bn_sprite_palette_items_customer_look11.h"
+#include "bn_sprite_palette_items_customer_look12.h"
+#include "bn_sprite_palette_items_customer_look13.h"
+#include "bn_sprite_palette_items_customer_look14.h"
+#include "bn_sprite_palette_items_customer_look2.h"
+#include "bn_sprite_palette_items_customer_look3.h"
+#include "bn_sprite_palette_items_customer_look4.h"
+#include "bn_sprite_palette_items_customer_look5.h"
+#include "bn_sprite_palette_items_customer_look6.h"
+#include "bn_sprite_palette_items_customer_look7.h"
+#include "bn_sprite_palette_items_customer_look8.h"
+#include "bn_sprite_palette_items_customer_look9.h"
 #include "ti_helpers.h"
+#include "ti_profiler.h"
 
 /**
- * @brief Anonymous namespace: low-level helpers for sprite and movement.
+ * @brief Anonymous namespace: low-level helpers for sprites.
+ * - _allocate_slot: VRAM for one frame of a sheet, filled in by hand.
  * - _create_sprite: Utility for building person sprites with z/horizontal
  * config.
  * - _create_shadow: Utility for shadow sprites with blending.
- * - get_next_step: See ti_helpers.h.
  */
 namespace {
+bn::sprite_tiles_ptr _allocate_slot(const bn::sprite_item& sprite) {
+  const bn::bpp_mode bpp = sprite.tiles_item().bpp();
+  return bn::sprite_tiles_ptr::allocate(sprite.shape_size().tiles_count(bpp),
+                                        bpp);
+}
+
 bn::sprite_ptr _create_sprite(bn::fixed_point position, bool is_left,
-                              bn::sprite_item sprite) {
-  bn::sprite_builder builder(sprite);
+                              const bn::sprite_item& sprite,
+                              const bn::sprite_tiles_ptr& tiles) {
+  bn::sprite_builder builder(sprite.shape_size(), tiles,
+                             sprite.palette_item().create_palette());
   builder.set_position(position);
   builder.set_z_order(-300);
   builder.set_horizontal_flip(is_left);
@@ -68,509 +71,140 @@ bn::sprite_ptr _create_shadow(bn::fixed_point position) {
 namespace ti {
 
 namespace {
-constexpr const bn::sprite_item* TYPE_TO_SPRITE[] = {
-    &bn::sprite_items::walk1,   // GREEN_SHIRT = 0
-    &bn::sprite_items::walk2,   // RED_SHIRT = 1
-    &bn::sprite_items::walk3,   // BLUE_SHIRT = 2
-    &bn::sprite_items::walk4,   // RED_SINGLET = 3
-    &bn::sprite_items::walk6,   // DWIGHT = 4
-    &bn::sprite_items::walk8,   // GIRL1 = 5
-    &bn::sprite_items::walk7,   // GIRL2 = 6
-    &bn::sprite_items::walk5,   // PALE_GREEN_SHIRT = 7
-    &bn::sprite_items::walk9,   // GIRL3 = 8
-    &bn::sprite_items::walk10,  // PERSON1 = 9
-    &bn::sprite_items::walk11,  // PERSON2 = 10
-    &bn::sprite_items::walk12,  // PERSON3 = 11
-    &bn::sprite_items::walk13,  // PERSON4 = 12
-    &bn::sprite_items::walk14,  // PERSON5 = 13
-};
-}  // namespace
-
-// This array must match the STATE enum order exactly.
-const Person::StateHandler Person::_state_handlers[] = {
-    &Person::_handle_walking_left,
-    &Person::_handle_walking_left_with_coffee,
-    &Person::_handle_walking_right,
-    &Person::_handle_walking_right_with_coffee,
-    &Person::_handle_entering,
-    &Person::_handle_walking_to_order,
-    &Person::_handle_waiting_to_order,
-    &Person::_handle_ordering,
-    &Person::_handle_walking_to_counter,
-    &Person::_handle_waiting,
-    &Person::_handle_walking_to_door,
-    &Person::_handle_exiting,
-    &Person::_handle_joining_queue,
-    &Person::_handle_walking_left_passer,
-    &Person::_handle_walking_right_passer,
+// Styles sharing a silhouette share one 4bpp body sheet in ROM and differ
+// only by palette. Only the body's tiles and the look are used: frames are
+// streamed into each customer's own VRAM slot (see upload_frame()). Bodies and
+// looks are generated from art/customers/ by tools/pack_customers.py; look N
+// recolours a body into what used to be walkN.bmp.
+constexpr bn::sprite_item _customer(const bn::sprite_item& body,
+                                    const bn::sprite_palette_item& look) {
+  return bn::sprite_item(body.shape_size(), body.tiles_item(), look);
+}
+
+constexpr bn::sprite_item TYPE_TO_SPRITE[] = {
+    _customer(bn::sprite_items::customer_body_a,
+              bn::sprite_palette_items::customer_look1),  // GREEN_SHIRT = 0
+    _customer(bn::sprite_items::customer_body_a,
+              bn::sprite_palette_items::customer_look2),  // RED_SHIRT = 1
+    _customer(bn::sprite_items::customer_body_a,
+              bn::sprite_palette_items::customer_look3),  // BLUE_SHIRT = 2
+    _customer(bn::sprite_items::customer_body_a,
+              bn::sprite_palette_items::customer_look4),  // RED_SINGLET = 3
+    _customer(bn::sprite_items::customer_body_a,
+              bn::sprite_palette_items::customer_look6),  // DWIGHT = 4
+    _customer(bn::sprite_items::customer_body_b,
+              bn::sprite_palette_items::customer_look8),  // GIRL1 = 5
+    _customer(bn::sprite_items::customer_body_b,
+              bn::sprite_palette_items::customer_look7),  // GIRL2 = 6
+    _customer(bn::sprite_items::customer_body_a,
+              bn::sprite_palette_items::customer_look5),  // PALE_GREEN_SHIRT
+    _customer(bn::sprite_items::customer_body_c,
+              bn::sprite_palette_items::customer_look9),  // GIRL3 = 8
+    _customer(bn::sprite_items::customer_body_c,
+              bn::sprite_palette_items::customer_look10),  // PERSON1 = 9
+    _customer(bn::sprite_items::customer_body_a,
+              bn::sprite_palette_items::customer_look11),  // PERSON2 = 10
+    _customer(bn::sprite_items::customer_body_a,
+              bn::sprite_palette_items::customer_look12),  // PERSON3 = 11
+    _customer(bn::sprite_items::customer_body_a,
+              bn::sprite_palette_items::customer_look13),  // PERSON4 = 12
+    _customer(bn::sprite_items::customer_body_a,
+              bn::sprite_palette_items::customer_look14),  // PERSON5 = 13
 };
 
-constexpr bool _ti_verify_state_handler_table() {
-  static_assert(
-      sizeof(Person::_state_handlers) / sizeof(Person::StateHandler) == 15,
-      "State handler table must match STATE enum.");
-  return true;
+const bn::sprite_item& _sprite_item_for(TYPE type) {
+  return TYPE_TO_SPRITE[static_cast<int>(type)];
 }
 
-constexpr bool _ti_state_handler_table_verified =
-    _ti_verify_state_handler_table();
-
-namespace {
-
-int locate_in_queue(const bn::deque<int, 8>& order_queue, int id) {
-  for (int i = 0; i < order_queue.size(); ++i) {
-    if (order_queue.at(i) == id) return i;
-  }
-  return -1;
+// True when neither the 32x32 body nor the 16x16 shadow below it is visible.
+bool _is_offscreen(const PersonSim& sim) {
+  const bn::fixed_point& position = sim.get_position();
+  return is_offscreen(position, 16, 16) &&
+         is_offscreen(bn::fixed_point(position.x(), position.y() + 15), 8, 8);
 }
 }  // namespace
 
-int Person::_active_loiterers = 0;
-
-Person::Person(START start, TYPE type, int id)
-    : _shadow(bn::sprite_items::shadow.create_sprite(0, 0)), _id(id) {
-  LOCATIONS.push_back(bn::fixed_point(-60, 12));
-  LOCATIONS.push_back(bn::fixed_point(-55, 15));
-  LOCATIONS.push_back(bn::fixed_point(-50, 18));
-  LOCATIONS.push_back(bn::fixed_point(-45, 21));
-  LOCATIONS.push_back(bn::fixed_point(-40, 24));
-
-  bn::random rng = bn::random();
-  for (int i = 0; i < _id; i++) {
-    rng.get();
-  }
-  _speed += rng.get_fixed(0.2) - 0.1;
-
-  bn::fixed_point pos = bn::fixed_point(-160, 60);
-  _state = STATE::WALKING_LEFT_W_COFFEE;
-  if (start == START::RIGHT) {
-    pos.set_x(160);
-    _state = STATE::WALKING_RIGHT_W_COFFEE;
-  } else if (start == START::COUNTER) {
-    pos = bn::fixed_point(-86, 14);
-    _state = STATE::WAITING;
-  }
-
-  setStyle(type, start, pos);
-
-  if (start == START::RIGHT) {
-    _sprite.value().set_horizontal_flip(true);
-  } else if (start == START::COUNTER) {
-    _sprite.value().set_horizontal_flip(true);
-    _sprite.value().set_z_order(-100);
-    _action = bn::create_sprite_animate_action_forever(
-        _sprite.value(), 20, _sprite_item.value().tiles_item(), 16, 16, 16, 16,
-        17, 17, 17, 17);
-  } else {
-    _sprite.value().set_horizontal_flip(false);
-  }
-
-  bn::fixed_point shadow_pos = _sprite.value().position();
-  shadow_pos.set_y(shadow_pos.y() + 15);
-  _shadow = _create_shadow(shadow_pos);
-}
-
-void Person::setStyle(TYPE type, START start, bn::fixed_point pos) {
-  if (start != START::COUNTER) {
-    pos.set_y(_randomized_street_y(pos.y()));
-  }
-  _type = type;
-  _sprite_item = *TYPE_TO_SPRITE[static_cast<int>(type)];
-  _sprite = _create_sprite(pos, start != START::RIGHT, _sprite_item.value());
-  _has_loitered = false;
-  _is_loitering = false;
-  _loiter_time = 0;
-  _loiter_duration_frames = 0;
-  _loiter_in_position = false;
-  _loiter_target_position = pos;
-  _action = bn::create_sprite_animate_action_forever(
-      _sprite.value(), 12, _sprite_item.value().tiles_item(), 0, 1, 2, 3, 4, 5,
-      6, 7);
-}
-
-TYPE Person::get_type() { return _type; }
-
-bn::fixed_point Person::_random_street_loiter_point() {
-  bn::fixed_point current_pos = _sprite.value().position();
-  bn::fixed target_x = current_pos.x();
-
-  switch (_state) {
-    case STATE::WALKING_LEFT:
-      target_x = OUTSIDE.x();
-      break;
-    case STATE::WALKING_RIGHT:
-      target_x = OUTSIDE.x();
-      break;
-    case STATE::WALKING_LEFT_W_COFFEE:
-      target_x = LEFT.x();
-      break;
-    case STATE::WALKING_RIGHT_W_COFFEE:
-      target_x = RIGHT.x();
-      break;
-    case STATE::WALKING_LEFT_PASSER:
-      target_x = LEFT.x();
-      break;
-    case STATE::WALKING_RIGHT_PASSER:
-      target_x = RIGHT.x();
-      break;
-    default:
-      break;
-  }
-
-  bn::fixed min_x = target_x;
-  bn::fixed max_x = current_pos.x();
-  if (min_x > max_x) {
-    bn::fixed temp = min_x;
-    min_x = max_x;
-    max_x = temp;
-  }
-
-  bn::fixed range = max_x - min_x;
-  if (range <= 0) {
-    return bn::fixed_point(current_pos.x(),
-                           _randomized_street_y(current_pos.y()));
-  }
-
-  bn::fixed random_offset = _random.get_fixed(range);
-  bn::fixed random_x = min_x + random_offset;
-  return bn::fixed_point(random_x, _randomized_street_y(current_pos.y()));
-}
-
-bn::fixed Person::_randomized_street_y(bn::fixed base_y) {
-  int offset = _random.get_int(21) - 10;
-  return base_y + bn::fixed(offset);
-}
-
-bool Person::_should_walk_by() {
-  if (_walk_by_chance <= 0) {
-    return false;
-  }
-  return _random.get_int(_walk_by_chance) == 0;
-}
-
-bool Person::_try_start_loitering() {
-  if (_has_loitered || _is_loitering || _active_loiterers >= _max_loiterers) {
-    return false;
-  }
-
-  constexpr int LOITER_CHANCE_FRAMES = 360;  // ~6 seconds average between tries
-  if (_random.get_int(LOITER_CHANCE_FRAMES) == 0) {
-    _begin_loitering();
-    return true;
-  }
-
-  return false;
-}
-
-void Person::_begin_loitering() {
-  _has_loitered = true;
-  _is_loitering = true;
-  _loiter_time = 0;
-  _loiter_duration_frames = (_random.get_int(9) + 2) * 60;
-  _loiter_target_position = _random_street_loiter_point();
-  _loiter_in_position = false;
-  _active_loiterers++;
-  bool already_at_target =
-      _sprite.value().position().x() == _loiter_target_position.x() &&
-      _sprite.value().position().y() == _loiter_target_position.y();
-  if (already_at_target) {
-    _loiter_in_position = true;
-    _action = bn::create_sprite_animate_action_forever(
-        _sprite.value(), 20, _sprite_item.value().tiles_item(), 16, 16, 16, 16,
-        17, 17, 17, 17);
-  } else {
-    _sprite.value().set_horizontal_flip(_loiter_target_position.x() <
-                                        _sprite.value().x());
-    _action = bn::create_sprite_animate_action_forever(
-        _sprite.value(), 12, _sprite_item.value().tiles_item(), 0, 1, 2, 3, 4,
-        5, 6, 7);
-  }
-}
-
-void Person::_stop_loitering() {
-  if (_active_loiterers > 0) {
-    --_active_loiterers;
-  }
-  _is_loitering = false;
-  _loiter_time = 0;
-  _loiter_duration_frames = 0;
-  _loiter_in_position = false;
-  bool face_left = _state == STATE::WALKING_LEFT ||
-                   _state == STATE::WALKING_LEFT_W_COFFEE ||
-                   _state == STATE::WALKING_LEFT_PASSER;
-  _sprite.value().set_horizontal_flip(face_left);
-  _action = bn::create_sprite_animate_action_forever(
-      _sprite.value(), 12, _sprite_item.value().tiles_item(), 0, 1, 2, 3, 4, 5,
-      6, 7);
-}
-
-bool Person::_update_loiter_overlay() {
-  if (!_is_loitering) {
-    return false;
-  }
-
-  if (_loiter_in_position) {
-    _loiter_time += 1;
-    if (_loiter_duration_frames > 0 &&
-        _loiter_time >= _loiter_duration_frames) {
-      _stop_loitering();
-    }
-  } else {
-    if (_advance_to(_loiter_target_position, false)) {
-      _loiter_in_position = true;
-      _action = bn::create_sprite_animate_action_forever(
-          _sprite.value(), 20, _sprite_item.value().tiles_item(), 16, 16, 16,
-          16, 17, 17, 17, 17);
-    }
-  }
-  return _is_loitering;
-}
-
-bool Person::_advance_to(const bn::fixed_point& target, bool may_loiter) {
-  bn::fixed_point next_step =
-      ti::get_next_step(_sprite.value().position(), target, _speed);
-  _sprite.value().set_position(next_step);
-  if (may_loiter && _try_start_loitering()) {
-    return false;
+Person::Person(const PersonSim& sim, int tick)
+    : _tiles(_allocate_slot(_sprite_item_for(sim.get_type()))),
+      _sprite(_create_sprite(sim.get_position(), sim.is_facing_left(),
+                             _sprite_item_for(sim.get_type()), _tiles)),
+      _shadow(_create_shadow(bn::fixed_point(sim.get_position().x(),
+                                             sim.get_position().y() + 15))),
+      _type(sim.get_type()) {
+  _player.play(sim.get_clip(), tick);
+  _show_frame(tick);
+  upload_frame();  // not on screen before the next commit anyway
+  if (_is_offscreen(sim)) {
+    _cull();
   }
-  return next_step.x() == target.x() && next_step.y() == target.y();
 }
 
-int Person::_state_index(STATE state) {
-  int idx = static_cast<int>(state) - 1;
-  return idx < 0 ? 0 : idx;
+void Person::_cull() {
+  _culled = true;
+  _sprite.set_visible(false);
+  _shadow.set_visible(false);
 }
 
-void Person::_handle_walking_right(bn::deque<int, 8>&, bool&, bool&,
-                                   bn::vector<int, 16>&) {
-  if (_advance_to(OUTSIDE, true)) {
-    if (_should_walk_by()) {
-      _state = STATE::WALKING_RIGHT_PASSER;
-      _sprite.value().set_horizontal_flip(false);
-      _action = bn::create_sprite_animate_action_forever(
-          _sprite.value(), 12, _sprite_item.value().tiles_item(), 0, 1, 2, 3, 4,
-          5, 6, 7);
-    } else {
-      _state = STATE::ENTERING;
-      _sprite.value().set_horizontal_flip(true);
-    }
-  }
-}
-
-void Person::_handle_walking_left(bn::deque<int, 8>&, bool&, bool&,
-                                  bn::vector<int, 16>&) {
-  if (_advance_to(OUTSIDE, true)) {
-    if (_should_walk_by()) {
-      _state = STATE::WALKING_LEFT_PASSER;
-      _sprite.value().set_horizontal_flip(true);
-      _action = bn::create_sprite_animate_action_forever(
-          _sprite.value(), 12, _sprite_item.value().tiles_item(), 0, 1, 2, 3, 4,
-          5, 6, 7);
-    } else {
-      _state = STATE::ENTERING;
-      _sprite.value().set_horizontal_flip(true);
-    }
-  }
-}
-
-void Person::_handle_entering(bn::deque<int, 8>&, bool&, bool&,
-                              bn::vector<int, 16>&) {
-  if (_advance_to(DOOR)) {
-    _state = STATE::WALKING_TO_ORDER;
-    _sprite.value().set_horizontal_flip(true);
-  }
-}
-
-void Person::_handle_walking_to_order(bn::deque<int, 8>&, bool&, bool&,
-                                      bn::vector<int, 16>&) {
-  if (_advance_to(QUEUE_START)) {
-    _state = STATE::JOINING_QUEUE;
-  }
-}
-
-void Person::_handle_joining_queue(bn::deque<int, 8>& order_queue,
-                                   bool& waiting_spot,
-                                   bool& purchased_this_frame,
-                                   bn::vector<int, 16>& types) {
-  (void)waiting_spot;
-  (void)purchased_this_frame;
-  (void)types;
-  int index = locate_in_queue(order_queue, _id);
-  if (index == -1) {
-    if (order_queue.size() >= 5) {
-      _state = STATE::WALKING_TO_DOOR;
-      _sprite.value().set_horizontal_flip(false);
-      return;
-    }
-    order_queue.push_back(_id);
-  } else {
-    // keep target tied to queue slot
-  }
-
-  bn::fixed_point target = index == -1 ? TILL : LOCATIONS.at(index);
-
-  if (_advance_to(target)) {
-    _state = STATE::WAITING_TO_ORDER;
-    _action = bn::create_sprite_animate_action_forever(
-        _sprite.value(), 20, _sprite_item.value().tiles_item(), 16, 16, 16, 16,
-        17, 17, 17, 17);
-    _sprite.value().set_horizontal_flip(true);
-  }
-}
-
-void Person::_handle_waiting_to_order(bn::deque<int, 8>& order_queue, bool&,
-                                      bool&, bn::vector<int, 16>&) {
-  int index = locate_in_queue(order_queue, _id);
-  const bn::fixed_point target = LOCATIONS.at(index);
-
-  if (_advance_to(target)) {
-    if (index == 0) {
-      _state = STATE::ORDERING;
-    }
-    _action = bn::create_sprite_animate_action_forever(
-        _sprite.value(), 20, _sprite_item.value().tiles_item(), 16, 16, 16, 16,
-        17, 17, 17, 17);
-  } else {
-    _action = bn::create_sprite_animate_action_forever(
-        _sprite.value(), 12, _sprite_item.value().tiles_item(), 0, 1, 2, 3, 4,
-        5, 6, 7);
-  }
-}
-
-void Person::_handle_ordering(bn::deque<int, 8>& order_queue, bool&,
-                              bool& purchased_this_frame,
-                              bn::vector<int, 16>&) {
-  _wait_time = _wait_time += 1;
-  if (_wait_time > _wait_max) {
-    purchased_this_frame = true;
-    _wait_time = 0;
-    _state = STATE::WALKING_TO_COUNTER;
-    order_queue.pop_front();
-    _action = bn::create_sprite_animate_action_forever(
-        _sprite.value(), 12, _sprite_item.value().tiles_item(), 0, 1, 2, 3, 4,
-        5, 6, 7);
-    _sprite.value().set_horizontal_flip(true);
-  }
-}
-
-void Person::_handle_walking_to_counter(bn::deque<int, 8>&, bool& waiting_spot,
-                                        bool&, bn::vector<int, 16>&) {
-  bn::fixed_point counter = waiting_spot ? COUNTER2 : COUNTER1;
-  if (_advance_to(counter)) {
-    _state = STATE::WAITING;
-    waiting_spot = !waiting_spot;
-    _action = bn::create_sprite_animate_action_forever(
-        _sprite.value(), 20, _sprite_item.value().tiles_item(), 16, 16, 16, 16,
-        17, 17, 17, 17);
-    _sprite.value().set_horizontal_flip(true);
+void Person::_show_frame(int tick) {
+  int frame = _player.frame(tick);
+  if (frame != _frame) {
+    _frame = frame;
+    _frame_pending = true;
   }
 }
 
-void Person::_handle_waiting(bn::deque<int, 8>&, bool&, bool&,
-                             bn::vector<int, 16>&) {
-  _wait_time = _wait_time += 1;
-  if (_wait_time > _wait_max + 60) {
-    _wait_time = 0;
-    _state = STATE::WALKING_TO_DOOR;
-    _action = bn::create_sprite_animate_action_forever(
-        _sprite.value(), 12, _sprite_item.value().tiles_item(), 8, 9, 10, 11,
-        12, 13, 14, 15);
-    _sprite.value().set_horizontal_flip(false);
-  }
-}
-
-void Person::_handle_walking_to_door(bn::deque<int, 8>&, bool&, bool&,
-                                     bn::vector<int, 16>&) {
-  if (_advance_to(DOOR)) {
-    _state = STATE::EXITING;
-    _sprite.value().set_horizontal_flip(false);
-  }
-}
-
-void Person::_handle_exiting(bn::deque<int, 8>&, bool&, bool&,
-                             bn::vector<int, 16>&) {
-  if (_advance_to(OUTSIDE)) {
-    bool is_left = _random.get_int(10) > 5;
-    if (is_left) {
-      _state = STATE::WALKING_LEFT_W_COFFEE;
-      _sprite.value().set_horizontal_flip(true);
-    } else {
-      _state = STATE::WALKING_RIGHT_W_COFFEE;
-      _sprite.value().set_horizontal_flip(false);
-    }
-  }
-  _sprite.value().set_z_order(-300);
-}
-
-void Person::_handle_walking_right_passer(bn::deque<int, 8>&, bool&, bool&,
-                                          bn::vector<int, 16>&) {
-  if (_advance_to(RIGHT, true)) {
-    _state = STATE::WALKING_LEFT;
-    _sprite.value().set_horizontal_flip(true);
-  }
-}
-
-void Person::_handle_walking_left_passer(bn::deque<int, 8>&, bool&, bool&,
-                                         bn::vector<int, 16>&) {
-  if (_advance_to(LEFT, true)) {
-    _state = STATE::WALKING_RIGHT;
-    _sprite.value().set_horizontal_flip(false);
-  }
-}
-
-void Person::_handle_walking_left_with_coffee(bn::deque<int, 8>&, bool&, bool&,
-                                              bn::vector<int, 16>& types) {
-  if (_advance_to(LEFT, true)) {
-    _respawn_from_side(START::LEFT, STATE::WALKING_RIGHT, false, types);
-  }
-}
-
-void Person::_handle_walking_right_with_coffee(bn::deque<int, 8>&, bool&, bool&,
-                                               bn::vector<int, 16>& types) {
-  if (_advance_to(RIGHT, true)) {
-    _respawn_from_side(START::RIGHT, STATE::WALKING_LEFT, true, types);
-  }
-}
-
-void Person::_respawn_from_side(START start_side, STATE next_state,
-                                bool face_left, bn::vector<int, 16>& types) {
-  if (types.empty()) {
+void Person::upload_frame() {
+  if (!_frame_pending) {
     return;
   }
-  int type_index = _random.get_int(types.size());
-  int next_type = types.at(type_index);
-  types.erase(types.begin() + type_index);
-  setStyle(static_cast<TYPE>(next_type), start_side,
-           _sprite.value().position());
-  _sprite.value().set_horizontal_flip(face_left);
-  _state = next_state;
+  _frame_pending = false;
+  const bn::span<const bn::tile> source =
+      _sprite_item_for(_type).tiles_item().graphics_tiles_ref(_frame);
+  bn::span<bn::tile> slot = *_tiles.vram();
+  bn::memory::copy(source[0], source.size(), slot[0]);
 }
 
 /**
- * @brief Main state machine update for the Person (customer) object.
+ * @brief Mirrors the simulation onto the sprite and shadow.
  *
- * Handles all movement, queuing, ordering, waiting, leaving logic per frame.
- * WARNING: Core to game balance—subtle changes deeply affect flow/feel!
- *
- * - order_queue: Global cafe customer queue by id
- * - waiting_spot: Reference flag for counter queue position
- * - purchased_this_frame: Set true if this customer buys during the update
- * - types: Pool of available style/type indices for respawning
+ * A style change (respawn) swaps the palette and streams the new body's
+ * frame. Clips restart only when the simulation asks for a different one.
+ * While the customer is fully offscreen both sprites stay hidden (freeing
+ * their OAM entries) and only the clip choice is tracked, so animation timing
+ * is unchanged on re-entry.
  */
-void Person::update(bn::deque<int, 8>& order_queue, bool& waiting_spot,
-                    bool& purchased_this_frame, bn::vector<int, 16>& types) {
-  if (!_update_loiter_overlay()) {
-    const StateHandler handler = _state_handlers[_state_index(_state)];
-    (this->*handler)(order_queue, waiting_spot, purchased_this_frame, types);
+void Person::update(const PersonSim& sim, int tick) {
+  TI_PROFILE_SCOPE(PROFILE_ZONE::PERSON);
+  if (_is_offscreen(sim)) {
+    _player.play(sim.get_clip(), tick);
+    if (!_culled) {
+      _cull();
+    }
+    return;
+  }
+  const bool was_culled = _culled;
+  if (_culled) {
+    _culled = false;
+    _sprite.set_visible(true);
+    _shadow.set_visible(true);
   }
 
-  _sprite.value().set_z_order(-_sprite.value().y().integer());
+  if (sim.get_type() != _type) {
+    _type = sim.get_type();
+    _sprite.set_palette(_sprite_item_for(_type).palette_item());
+    _frame = -1;  // the new style may have a different body
+  }
+  _player.play(sim.get_clip(), tick);
+  _show_frame(tick);
+  if (was_culled) {
+    upload_frame();  // hidden until the next commit, so safe to write now
+  }
 
-  _shadow.set_x(_sprite.value().x());
-  _shadow.set_y(_sprite.value().y() + 15);
+  _sprite.set_position(sim.get_position());
+  _sprite.set_horizontal_flip(sim.is_facing_left());
+  _sprite.set_z_order(-_sprite.y().integer());
 
-  if (_action.has_value() && !_action.value().done()) {
-    _action.value().update();
-  }
+  _shadow.set_x(_sprite.x());
+  _shadow.set_y(_sprite.y() + 15);
 }
-}  // namespace ti
\ No newline at end of file
+}  // namespace ti
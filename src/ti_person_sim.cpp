@@ -0,0 +1,500 @@
+/**
+ * @file ti_person_sim.cpp
+ * @brief Implements the render-free customer simulation (see ti_person_sim.h).
+ *
+ * Contains core state machine logic, queue/ordering workflow, loitering and
+ * per-customer lifecycle management for the main gameplay flow. Nothing here
+ * may include sprite headers: this file is also built by the host tests.
+ *
+ * Agent/Contributor notes:
+ *   - This file is tightly coupled with the game balance and overall tempo.
+ *   - Magic numbers and queue-related quirks are a legacy from the rapid game
+ * jam build.
+ *   - If making changes, test thoroughly in-emulator, as small tweaks have
+ * game-wide effects!
+ */
+
+#include "ti_person_sim.h"
+
+#include "ti_helpers.h"
+
+namespace ti {
+
+// This array must match the STATE enum order exactly.
+const PersonSim::StateHandler PersonSim::_state_handlers[] = {
+    &PersonSim::_handle_walking_left,
+    &PersonSim::_handle_walking_left_with_coffee,
+    &PersonSim::_handle_walking_right,
+    &PersonSim::_handle_walking_right_with_coffee,
+    &PersonSim::_handle_entering,
+    &PersonSim::_handle_walking_to_order,
+    &PersonSim::_handle_waiting_to_order,
+    &PersonSim::_handle_ordering,
+    &PersonSim::_handle_walking_to_counter,
+    &PersonSim::_handle_waiting,
+    &PersonSim::_handle_walking_to_door,
+    &PersonSim::_handle_exiting,
+    &PersonSim::_handle_joining_queue,
+    &PersonSim::_handle_walking_left_passer,
+    &PersonSim::_handle_walking_right_passer,
+};
+
+constexpr bool _ti_verify_state_handler_table() {
+  static_assert(
+      sizeof(PersonSim::_state_handlers) / sizeof(PersonSim::StateHandler) ==
+          15,
+      "State handler table must match STATE enum.");
+  return true;
+}
+
+constexpr bool _ti_state_handler_table_verified =
+    _ti_verify_state_handler_table();
+
+PersonSim::PersonSim(START start, TYPE type, int id, unsigned seed)
+    : _random(Rng::stream(seed, id)),
+      _face_left(false),
+      _has_loitered(false),
+      _is_loitering(false),
+      _loiter_in_position(false),
+      _id(id) {
+  _speed += _random.get_fixed(0.2) - 0.1;
+
+  bn::fixed_point pos = bn::fixed_point(-160, 60);
+  _state = STATE::WALKING_LEFT_W_COFFEE;
+  if (start == START::RIGHT) {
+    pos.set_x(160);
+    _state = STATE::WALKING_RIGHT_W_COFFEE;
+  } else if (start == START::COUNTER) {
+    pos = CAFE_LAYOUT.counter2;
+    _state = STATE::WAITING;
+  }
+
+  setStyle(type, start, pos);
+
+  if (start == START::RIGHT) {
+    _face_left = true;
+  } else if (start == START::COUNTER) {
+    _face_left = true;
+    _play(CLIP::IDLE);
+  } else {
+    _face_left = false;
+  }
+}
+
+void PersonSim::setStyle(TYPE type, START start, bn::fixed_point pos) {
+  if (start != START::COUNTER) {
+    pos.set_y(_randomized_street_y(pos.y()));
+  }
+  _type = type;
+  _position = pos;
+  _leg_steps_left = -1;
+  _face_left = start != START::RIGHT;
+  _has_loitered = false;
+  _is_loitering = false;
+  _loiter_time = 0;
+  _loiter_duration_frames = 0;
+  _loiter_in_position = false;
+  _loiter_target_position = pos;
+  _play(CLIP::WALK);
+}
+
+void PersonSim::_play(CLIP clip) { _clip = clip; }
+
+int PersonSim::get_id() const { return _id; }
+
+TYPE PersonSim::get_type() const { return _type; }
+
+void PersonSim::set_type(TYPE type) { _type = type; }
+
+STATE PersonSim::get_state() const { return _state; }
+
+const bn::fixed_point& PersonSim::get_position() const { return _position; }
+
+bn::fixed PersonSim::get_speed() const { return _speed; }
+
+bool PersonSim::is_facing_left() const { return _face_left; }
+
+CLIP PersonSim::get_clip() const { return _clip; }
+
+bn::fixed_point PersonSim::_random_street_loiter_point() {
+  bn::fixed_point current_pos = _position;
+  bn::fixed target_x = current_pos.x();
+
+  switch (_state) {
+    case STATE::WALKING_LEFT:
+      target_x = CAFE_LAYOUT.outside.x();
+      break;
+    case STATE::WALKING_RIGHT:
+      target_x = CAFE_LAYOUT.outside.x();
+      break;
+    case STATE::WALKING_LEFT_W_COFFEE:
+      target_x = CAFE_LAYOUT.left.x();
+      break;
+    case STATE::WALKING_RIGHT_W_COFFEE:
+      target_x = CAFE_LAYOUT.right.x();
+      break;
+    case STATE::WALKING_LEFT_PASSER:
+      target_x = CAFE_LAYOUT.left.x();
+      break;
+    case STATE::WALKING_RIGHT_PASSER:
+      target_x = CAFE_LAYOUT.right.x();
+      break;
+    default:
+      break;
+  }
+
+  bn::fixed min_x = target_x;
+  bn::fixed max_x = current_pos.x();
+  if (min_x > max_x) {
+    bn::fixed temp = min_x;
+    min_x = max_x;
+    max_x = temp;
+  }
+
+  bn::fixed range = max_x - min_x;
+  if (range <= 0) {
+    return bn::fixed_point(current_pos.x(),
+                           _randomized_street_y(current_pos.y()));
+  }
+
+  bn::fixed random_offset = _random.get_fixed(range);
+  bn::fixed random_x = min_x + random_offset;
+  return bn::fixed_point(random_x, _randomized_street_y(current_pos.y()));
+}
+
+bn::fixed PersonSim::_randomized_street_y(bn::fixed base_y) {
+  int offset = _random.get_int(21) - 10;
+  return base_y + bn::fixed(offset);
+}
+
+bool PersonSim::_should_walk_by() {
+  if (WALK_BY_CHANCE <= 0) {
+    return false;
+  }
+  return _random.get_int(WALK_BY_CHANCE) == 0;
+}
+
+bool PersonSim::_try_start_loitering(int& active_loiterers) {
+  if (_has_loitered || _is_loitering || active_loiterers >= _max_loiterers) {
+    return false;
+  }
+
+  if (_random.get_int(_loiter_chance_frames) == 0) {
+    _begin_loitering(active_loiterers);
+    return true;
+  }
+
+  return false;
+}
+
+void PersonSim::_begin_loitering(int& active_loiterers) {
+  _has_loitered = true;
+  _is_loitering = true;
+  _loiter_time = 0;
+  _loiter_duration_frames =
+      (_random.get_int(LOITER_SECONDS_SPREAD) + LOITER_SECONDS_MIN) * 60;
+  _loiter_target_position = _random_street_loiter_point();
+  _loiter_in_position = false;
+  _leg_steps_left = -1;
+  active_loiterers++;
+  bool already_at_target = _position.x() == _loiter_target_position.x() &&
+                           _position.y() == _loiter_target_position.y();
+  if (already_at_target) {
+    _loiter_in_position = true;
+    _play(CLIP::IDLE);
+  } else {
+    _face_left = _loiter_target_position.x() < _position.x();
+    _play(CLIP::WALK);
+  }
+}
+
+void PersonSim::_stop_loitering(int& active_loiterers) {
+  if (active_loiterers > 0) {
+    --active_loiterers;
+  }
+  _is_loitering = false;
+  _loiter_time = 0;
+  _loiter_duration_frames = 0;
+  _loiter_in_position = false;
+  _leg_steps_left = -1;
+  _face_left = _state == STATE::WALKING_LEFT ||
+               _state == STATE::WALKING_LEFT_W_COFFEE ||
+               _state == STATE::WALKING_LEFT_PASSER;
+  _play(CLIP::WALK);
+}
+
+bool PersonSim::_update_loiter_overlay(int& active_loiterers) {
+  if (!_is_loitering) {
+    return false;
+  }
+
+  if (_loiter_in_position) {
+    _loiter_time += 1;
+    if (_loiter_duration_frames > 0 &&
+        _loiter_time >= _loiter_duration_frames) {
+      _stop_loitering(active_loiterers);
+    }
+  } else {
+    if (_advance_to(_loiter_target_position)) {
+      _loiter_in_position = true;
+      _play(CLIP::IDLE);
+    }
+  }
+  return _is_loitering;
+}
+
+/**
+ * @brief Caches the velocity and step count for walking from the current
+ * position to "target", so the heading is computed once per leg.
+ */
+void PersonSim::_start_leg(const bn::fixed_point& target) {
+  _leg_target = target;
+  _leg_step = ti::get_step_vector(_position, target, _speed);
+  _leg_steps_left = ti::count_steps_to(_position, target, _leg_step);
+}
+
+bool PersonSim::_advance_to(const bn::fixed_point& target,
+                            int* active_loiterers) {
+  if (_leg_steps_left < 0 || _leg_target.x() != target.x() ||
+      _leg_target.y() != target.y()) {
+    _start_leg(target);
+  }
+  bool arrived = _leg_steps_left == 0;
+  if (arrived) {
+    _position = target;
+  } else {
+    _position.set_x(_position.x() + _leg_step.x());
+    _position.set_y(_position.y() + _leg_step.y());
+    --_leg_steps_left;
+  }
+  if (active_loiterers && _try_start_loitering(*active_loiterers)) {
+    return false;
+  }
+  return arrived;
+}
+
+int PersonSim::_state_index(STATE state) {
+  int idx = static_cast<int>(state) - 1;
+  return idx < 0 ? 0 : idx;
+}
+
+void PersonSim::_handle_walking_right(OrderQueue&, bool&, bool&,
+                                      StylePool&, int& active_loiterers) {
+  if (_advance_to(CAFE_LAYOUT.outside, &active_loiterers)) {
+    if (_should_walk_by()) {
+      _state = STATE::WALKING_RIGHT_PASSER;
+      _face_left = false;
+      _play(CLIP::WALK);
+    } else {
+      _state = STATE::ENTERING;
+      _face_left = true;
+    }
+  }
+}
+
+void PersonSim::_handle_walking_left(OrderQueue&, bool&, bool&,
+                                     StylePool&, int& active_loiterers) {
+  if (_advance_to(CAFE_LAYOUT.outside, &active_loiterers)) {
+    if (_should_walk_by()) {
+      _state = STATE::WALKING_LEFT_PASSER;
+      _face_left = true;
+      _play(CLIP::WALK);
+    } else {
+      _state = STATE::ENTERING;
+      _face_left = true;
+    }
+  }
+}
+
+void PersonSim::_handle_entering(OrderQueue&, bool&, bool&,
+                                 StylePool&, int&) {
+  if (_advance_to(CAFE_LAYOUT.door)) {
+    _state = STATE::WALKING_TO_ORDER;
+    _face_left = true;
+  }
+}
+
+void PersonSim::_handle_walking_to_order(OrderQueue&, bool&, bool&,
+                                         StylePool&, int&) {
+  if (_advance_to(CAFE_LAYOUT.queue_start)) {
+    _state = STATE::JOINING_QUEUE;
+  }
+}
+
+void PersonSim::_handle_joining_queue(OrderQueue& order_queue, bool&, bool&,
+                                      StylePool&, int&) {
+  // The first step after joining still heads for the till, as it always has.
+  bn::fixed_point target = CAFE_LAYOUT.till;
+  if (_queue_ticket == -1) {
+    if (order_queue.full()) {
+      _state = STATE::WALKING_TO_DOOR;
+      _face_left = false;
+      return;
+    }
+    _queue_ticket = order_queue.join();
+    _queue_generation = order_queue.generation();
+    _queue_spot = OrderQueue::slot_position(order_queue.slot(_queue_ticket));
+  } else {
+    target = _queue_spot_in(order_queue);
+  }
+
+  if (_advance_to(target)) {
+    _state = STATE::WAITING_TO_ORDER;
+    _play(CLIP::IDLE);
+    _face_left = true;
+  }
+}
+
+void PersonSim::_handle_waiting_to_order(OrderQueue& order_queue, bool&,
+                                         bool&, StylePool&, int&) {
+  if (_advance_to(_queue_spot_in(order_queue))) {
+    if (order_queue.slot(_queue_ticket) == 0) {
+      _state = STATE::ORDERING;
+    }
+    _play(CLIP::IDLE);
+  } else {
+    _play(CLIP::WALK);
+  }
+}
+
+void PersonSim::_handle_ordering(OrderQueue& order_queue, bool&,
+                                 bool& purchased_this_frame, StylePool&, int&) {
+  ++_wait_time;
+  if (_wait_time > WAIT_MAX) {
+    purchased_this_frame = true;
+    _wait_time = 0;
+    _state = STATE::WALKING_TO_COUNTER;
+    order_queue.advance();
+    _queue_ticket = -1;
+    _play(CLIP::WALK);
+    _face_left = true;
+  }
+}
+
+const bn::fixed_point& PersonSim::_queue_spot_in(
+    const OrderQueue& order_queue) {
+  if (_queue_generation != order_queue.generation()) {
+    _queue_generation = order_queue.generation();
+    _queue_spot = OrderQueue::slot_position(order_queue.slot(_queue_ticket));
+  }
+  return _queue_spot;
+}
+
+void PersonSim::_handle_walking_to_counter(OrderQueue&,
+                                           bool& waiting_spot, bool&,
+                                           StylePool&, int&) {
+  const bn::fixed_point& counter =
+      waiting_spot ? CAFE_LAYOUT.counter2 : CAFE_LAYOUT.counter1;
+  if (_advance_to(counter)) {
+    _state = STATE::WAITING;
+    waiting_spot = !waiting_spot;
+    _play(CLIP::IDLE);
+    _face_left = true;
+  }
+}
+
+void PersonSim::_handle_waiting(OrderQueue&, bool&, bool&,
+                                StylePool&, int&) {
+  ++_wait_time;
+  if (_wait_time > WAIT_MAX + 60) {
+    _wait_time = 0;
+    _state = STATE::WALKING_TO_DOOR;
+    _play(CLIP::WALK_W_COFFEE);
+    _face_left = false;
+  }
+}
+
+void PersonSim::_handle_walking_to_door(OrderQueue&, bool&, bool&,
+                                        StylePool&, int&) {
+  if (_advance_to(CAFE_LAYOUT.door)) {
+    _state = STATE::EXITING;
+    _face_left = false;
+  }
+}
+
+void PersonSim::_handle_exiting(OrderQueue&, bool&, bool&,
+                                StylePool&, int&) {
+  if (_advance_to(CAFE_LAYOUT.outside)) {
+    bool is_left = _random.get_int(10) >= 10 - EXIT_LEFT_ODDS;
+    if (is_left) {
+      _state = STATE::WALKING_LEFT_W_COFFEE;
+      _face_left = true;
+    } else {
+      _state = STATE::WALKING_RIGHT_W_COFFEE;
+      _face_left = false;
+    }
+  }
+}
+
+void PersonSim::_handle_walking_right_passer(OrderQueue&, bool&, bool&,
+                                             StylePool&,
+                                             int& active_loiterers) {
+  if (_advance_to(CAFE_LAYOUT.right, &active_loiterers)) {
+    _state = STATE::WALKING_LEFT;
+    _face_left = true;
+  }
+}
+
+void PersonSim::_handle_walking_left_passer(OrderQueue&, bool&, bool&,
+                                            StylePool&, int& active_loiterers) {
+  if (_advance_to(CAFE_LAYOUT.left, &active_loiterers)) {
+    _state = STATE::WALKING_RIGHT;
+    _face_left = false;
+  }
+}
+
+void PersonSim::_handle_walking_left_with_coffee(OrderQueue&, bool&,
+                                                 bool&,
+                                                 StylePool& styles,
+                                                 int& active_loiterers) {
+  if (_advance_to(CAFE_LAYOUT.left, &active_loiterers)) {
+    _respawn_from_side(START::LEFT, STATE::WALKING_RIGHT, false, styles);
+  }
+}
+
+void PersonSim::_handle_walking_right_with_coffee(OrderQueue&, bool&,
+                                                  bool&,
+                                                  StylePool& styles,
+                                                  int& active_loiterers) {
+  if (_advance_to(CAFE_LAYOUT.right, &active_loiterers)) {
+    _respawn_from_side(START::RIGHT, STATE::WALKING_LEFT, true, styles);
+  }
+}
+
+void PersonSim::_respawn_from_side(START start_side, STATE next_state,
+                                   bool face_left, StylePool& styles) {
+  // With every style worn (more customers than styles), or as many as the
+  // looks may be, come back as is.
+  TYPE next_type = _type;
+  if (styles.can_change(static_cast<int>(_type))) {
+    next_type = static_cast<TYPE>(styles.pick(_random));
+    styles.acquire(static_cast<int>(next_type));
+    styles.release(static_cast<int>(_type));
+  }
+  setStyle(next_type, start_side, _position);
+  _face_left = face_left;
+  _state = next_state;
+}
+
+/**
+ * @brief Main state machine update for the customer simulation.
+ *
+ * Handles all movement, queuing, ordering, waiting, leaving logic per frame.
+ * WARNING: Core to game balance—subtle changes deeply affect flow/feel!
+ *
+ * - order_queue: Global cafe line; holds this customer's ticket while queued
+ * - waiting_spot: Reference flag for counter queue position
+ * - purchased_this_frame: Set true if this customer buys during the update
+ * - styles: Styles not worn by anyone in play, for respawning
+ * - active_loiterers: Customers of the same crowd loitering right now
+ */
+void PersonSim::update(OrderQueue& order_queue, bool& waiting_spot,
+                       bool& purchased_this_frame, StylePool& styles,
+                       int& active_loiterers) {
+  if (!_update_loiter_overlay(active_loiterers)) {
+    const StateHandler handler = _state_handlers[_state_index(_state)];
+    (this->*handler)(order_queue, waiting_spot, purchased_this_frame, styles,
+                     active_loiterers);
+  }
+}
+}  // namespace ti
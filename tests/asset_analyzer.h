@@ -0,0 +1,574 @@
+/**
+ * @file asset_analyzer.h
+ * @brief Host-side reader and statistics for the BMP+JSON pairs in
+ * graphics/, as the Butano asset pipeline sees them.
+ *
+ * read_bmp(): Indexed 4bpp or 8bpp BMP into palette indices.
+ * parse_descriptor(): The few JSON fields Butano's importer reads.
+ * analyze(): Tiles, unique tiles after flip-dedup, colours and ROM size of
+ * one asset, compressed as its descriptor asks.
+ * compressed_size(): Size of data in the GBA BIOS LZ77, RLE and Huffman
+ * formats Butano imports compressed assets in.
+ * scene_budget(): Sprite VRAM, background VRAM, palette banks and load-time
+ * decompression of a set of assets on screen together.
+ *
+ * Used by asset_report (registered with CTest) and test_asset_analyzer.cpp.
+ */
+#ifndef TI_ASSET_ANALYZER_H
+#define TI_ASSET_ANALYZER_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ti {
+
+// GBA video memory, from GBATEK.
+constexpr int TILE_PIXELS = 8;
+constexpr int SPRITE_VRAM_BYTES = 32 * 1024;
+constexpr int BG_VRAM_BYTES = 64 * 1024;
+constexpr int SPRITE_PALETTE_BANKS = 16;
+constexpr int BANK_COLORS = 16;
+constexpr int BG_MAP_ENTRY_BYTES = 2;
+constexpr int FRAME_CYCLES = 280896;  // 228 scanlines of 1232 cycles
+constexpr int VBLANK_CYCLES = 83776;  // the last 68 of them
+
+// Most CPU time unpacking may take per KB it writes. A scene's compressed
+// assets are unpacked while it loads, which should be over within
+// LOAD_BUDGET_FRAMES; a sprite may also be created mid-game (e.g. a bought
+// upgrade), so unpacking one must fit in VBlank. Check these on hardware
+// with the "load" line a profiler build logs (see main.cpp) after changing
+// compressed assets.
+constexpr int RUN_LENGTH_CYCLES_PER_KB = 24 * 1024;
+constexpr int LZ77_CYCLES_PER_KB = 40 * 1024;
+constexpr int HUFFMAN_CYCLES_PER_KB = 160 * 1024;
+constexpr int LOAD_BUDGET_FRAMES = 10;
+
+/**
+ * @brief Palette indices of an indexed bitmap, top row first.
+ */
+struct Bitmap {
+  int width = 0;
+  int height = 0;
+  int bpp = 0;
+  int palette_size = 0;
+  std::vector<std::uint32_t> colors;  // 0xRRGGBB per palette entry
+  std::vector<unsigned char> pixels;
+
+  [[nodiscard]] int at(int x, int y) const { return pixels[y * width + x]; }
+};
+
+/**
+ * @brief Reads an uncompressed indexed BMP.
+ * @return False if the file is missing or not 4/8bpp indexed.
+ */
+inline bool read_bmp(const std::string &path, Bitmap &bitmap) {
+  std::ifstream file(path, std::ios::binary);
+  const std::vector<unsigned char> data(
+      (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  auto u32 = [&](std::size_t offset) {
+    return std::uint32_t(data[offset]) | std::uint32_t(data[offset + 1]) << 8 |
+           std::uint32_t(data[offset + 2]) << 16 |
+           std::uint32_t(data[offset + 3]) << 24;
+  };
+  if (data.size() < 54 || data[0] != 'B' || data[1] != 'M' ||
+      u32(30) != 0) {
+    return false;
+  }
+  const std::uint32_t offset = u32(10);
+  const int height = int(u32(22));
+  bitmap.width = int(u32(18));
+  bitmap.height = height < 0 ? -height : height;
+  bitmap.bpp = data[28] | data[29] << 8;
+  if (bitmap.bpp != 4 && bitmap.bpp != 8) {
+    return false;
+  }
+  bitmap.palette_size = u32(46) != 0 ? int(u32(46)) : 1 << bitmap.bpp;
+  const std::size_t table = 14 + std::size_t(u32(14));
+  if (data.size() < table + bitmap.palette_size * 4) {
+    return false;
+  }
+  bitmap.colors.resize(bitmap.palette_size);
+  for (int index = 0; index < bitmap.palette_size; ++index) {
+    bitmap.colors[index] = u32(table + index * 4) & 0xffffff;
+  }
+
+  const std::size_t stride = (bitmap.width * bitmap.bpp + 31) / 32 * 4;
+  if (data.size() < offset + stride * bitmap.height) {
+    return false;
+  }
+  bitmap.pixels.assign(std::size_t(bitmap.width) * bitmap.height, 0);
+  for (int y = 0; y < bitmap.height; ++y) {
+    const int source_y = height > 0 ? bitmap.height - 1 - y : y;
+    const unsigned char *row = &data[offset + source_y * stride];
+    for (int x = 0; x < bitmap.width; ++x) {
+      bitmap.pixels[y * bitmap.width + x] =
+          bitmap.bpp == 8 ? row[x] : (row[x / 2] >> (x % 2 ? 0 : 4)) & 15;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief JSON descriptor fields that affect how an asset is imported.
+ */
+struct AssetDescriptor {
+  std::string type;       // "sprite", "regular_bg", "sprite_palette", ...
+  int height = 0;         // sprite frame height; 0 is the whole image
+  std::string bpp_mode;   // empty unless overridden
+  std::string compression;  // "lz77", "run_length", "huffman", "auto"; empty
+                            // or "none" leaves the asset uncompressed
+};
+
+/**
+ * @brief Pulls known keys out of a flat JSON object. Descriptors are a
+ * handful of string and integer fields, so no general parser is needed.
+ */
+inline AssetDescriptor parse_descriptor(const std::string &json) {
+  auto value_of = [&](const std::string &key) -> std::string {
+    std::size_t at = json.find('"' + key + '"');
+    if (at == std::string::npos) {
+      return "";
+    }
+    at = json.find(':', at);
+    at = json.find_first_not_of(" \t\r\n", at + 1);
+    if (at == std::string::npos) {
+      return "";
+    }
+    if (json[at] == '"') {
+      return json.substr(at + 1, json.find('"', at + 1) - at - 1);
+    }
+    return json.substr(at, json.find_first_of(",} \t\r\n", at) - at);
+  };
+  AssetDescriptor descriptor;
+  descriptor.type = value_of("type");
+  const std::string height = value_of("height");
+  descriptor.height = height.empty() ? 0 : std::stoi(height);
+  descriptor.bpp_mode = value_of("bpp_mode");
+  descriptor.compression = value_of("compression");
+  return descriptor;
+}
+
+/**
+ * @brief What one asset costs and how much of that it needs.
+ */
+struct AssetStats {
+  std::string name;
+  std::string type;
+  int bpp = 8;             // as imported
+  int frames = 1;          // graphics in a sprite sheet
+  int frame_tiles = 0;     // 8x8 tiles per frame (per background)
+  int tiles = 0;           // all frames
+  int unique_tiles = 0;    // tiles left after merging flipped duplicates
+  int empty_tiles = 0;     // fully transparent (index 0) tiles
+  int colors = 0;          // distinct palette indices used, index 0 included
+  int highest_index = 0;   // highest palette index used
+  int rom_bytes = 0;       // tiles, map and palette up to highest_index
+  int raw_bytes = 0;       // rom_bytes before compression
+  std::string compression;  // codec "auto" picked; empty if uncompressed
+  bool bpp4_eligible = false;  // fits one 16-colour palette bank
+  std::vector<std::uint32_t> palette;  // 4bpp only: the bank it loads
+
+  [[nodiscard]] int tile_bytes() const { return bpp * TILE_PIXELS; }
+
+  /**
+   * @brief Whether the game can still use the asset with its compression.
+   * Animated sprites switch frames by pointing at them in ROM, and customer
+   * frames are copied from there, so sprite sheets must stay uncompressed.
+   */
+  [[nodiscard]] bool compression_supported() const {
+    return compression.empty() || type != "sprite" || frames == 1;
+  }
+
+  /** @return CPU cycles unpacking the asset costs, 0 if uncompressed */
+  [[nodiscard]] long long decompress_cycles() const {
+    int cycles_per_kb = 0;
+    if (compression == "run_length") {
+      cycles_per_kb = RUN_LENGTH_CYCLES_PER_KB;
+    } else if (compression == "lz77") {
+      cycles_per_kb = LZ77_CYCLES_PER_KB;
+    } else if (compression == "huffman") {
+      cycles_per_kb = HUFFMAN_CYCLES_PER_KB;
+    }
+    return (static_cast<long long>(raw_bytes) * cycles_per_kb + 1023) / 1024;
+  }
+};
+
+namespace detail {
+using Tile = std::array<unsigned char, TILE_PIXELS * TILE_PIXELS>;
+
+inline Tile read_tile(const Bitmap &bitmap, int tile_x, int tile_y) {
+  Tile tile{};
+  for (int y = 0; y < TILE_PIXELS; ++y) {
+    for (int x = 0; x < TILE_PIXELS; ++x) {
+      tile[y * TILE_PIXELS + x] =
+          bitmap.at(tile_x * TILE_PIXELS + x, tile_y * TILE_PIXELS + y);
+    }
+  }
+  return tile;
+}
+
+// The smallest of a tile and its three flips, so flipped copies compare
+// equal, like a background map entry's flip bits allow.
+inline Tile canonical(const Tile &tile) {
+  Tile best = tile;
+  for (int flip = 1; flip < 4; ++flip) {
+    Tile flipped{};
+    for (int y = 0; y < TILE_PIXELS; ++y) {
+      for (int x = 0; x < TILE_PIXELS; ++x) {
+        const int source_x = flip & 1 ? TILE_PIXELS - 1 - x : x;
+        const int source_y = flip & 2 ? TILE_PIXELS - 1 - y : y;
+        flipped[y * TILE_PIXELS + x] = tile[source_y * TILE_PIXELS + source_x];
+      }
+    }
+    best = std::min(best, flipped);
+  }
+  return best;
+}
+
+// Appends a tile as the GBA stores it: a byte per pixel at 8bpp, two pixels
+// per byte (left one in the low nibble) at 4bpp.
+inline void append_tile(const Tile &tile, int bpp,
+                        std::vector<unsigned char> &data) {
+  for (std::size_t pixel = 0; pixel < tile.size(); pixel += 2) {
+    if (bpp == 8) {
+      data.push_back(tile[pixel]);
+      data.push_back(tile[pixel + 1]);
+    } else {
+      data.push_back((tile[pixel] & 15) | (tile[pixel + 1] & 15) << 4);
+    }
+  }
+}
+
+constexpr int round_to_word(int bytes) { return (bytes + 3) / 4 * 4; }
+
+// GBA BIOS RLE: runs of 3 to 130 equal bytes take 2 bytes, anything else
+// goes in literal blocks of up to 128 bytes plus a flag byte.
+inline int run_length_size(const std::vector<unsigned char> &data) {
+  const std::size_t size = data.size();
+  auto run_at = [&](std::size_t at) {
+    std::size_t run = 1;
+    while (at + run < size && run < 130 && data[at + run] == data[at]) {
+      ++run;
+    }
+    return run;
+  };
+  int bytes = 4;
+  std::size_t at = 0;
+  while (at < size) {
+    const std::size_t run = run_at(at);
+    if (run >= 3) {
+      bytes += 2;
+      at += run;
+      continue;
+    }
+    int literals = 0;
+    while (at < size && literals < 128 && run_at(at) < 3) {
+      ++at;
+      ++literals;
+    }
+    bytes += 1 + literals;
+  }
+  return round_to_word(bytes);
+}
+
+// GBA BIOS LZ77, greedy: a flag byte per 8 blocks, each block a literal
+// byte or a 2-byte copy of 3 to 18 bytes from up to 4 KB back. Copies start
+// at least 2 bytes back, so the data can be unpacked straight into VRAM.
+inline int lz77_size(const std::vector<unsigned char> &data) {
+  constexpr int WINDOW = 4096;
+  constexpr int MIN_MATCH = 3;
+  constexpr int MAX_MATCH = 18;
+  const int size = int(data.size());
+  int bytes = 4;
+  int blocks = 0;
+  int at = 0;
+  while (at < size) {
+    int best = 0;
+    for (int distance = 2; distance <= std::min(WINDOW, at); ++distance) {
+      int length = 0;
+      while (length < MAX_MATCH && at + length < size &&
+             data[at + length] == data[at - distance + length]) {
+        ++length;
+      }
+      if (length > best) {
+        best = length;
+        if (best == MAX_MATCH) {
+          break;
+        }
+      }
+    }
+    if (blocks++ % 8 == 0) {
+      ++bytes;
+    }
+    if (best >= MIN_MATCH) {
+      bytes += 2;
+      at += best;
+    } else {
+      ++bytes;
+      ++at;
+    }
+  }
+  return round_to_word(bytes);
+}
+
+// GBA BIOS Huffman over bytes: a tree of one byte per node plus the coded
+// bits in 32-bit words.
+inline int huffman_size(const std::vector<unsigned char> &data) {
+  std::array<long long, 256> counts{};
+  for (unsigned char byte : data) {
+    ++counts[byte];
+  }
+  std::priority_queue<long long, std::vector<long long>,
+                      std::greater<long long>>
+      weights;
+  for (long long count : counts) {
+    if (count != 0) {
+      weights.push(count);
+    }
+  }
+  const int leaves = int(weights.size());
+  // Every merge adds one bit to the code of each byte below it, so the
+  // coded length is the sum of the merged weights.
+  long long bits = leaves == 1 ? static_cast<long long>(data.size()) : 0;
+  while (weights.size() > 1) {
+    const long long first = weights.top();
+    weights.pop();
+    const long long merged = first + weights.top();
+    weights.pop();
+    bits += merged;
+    weights.push(merged);
+  }
+  const int tree_bytes = round_to_word(1 + std::max(2 * leaves - 1, 1));
+  return 4 + tree_bytes + int((bits + 31) / 32 * 4);
+}
+}  // namespace detail
+
+/**
+ * @brief Bytes "data" takes compressed with "compression", as named in asset
+ * descriptors. "auto" is the smallest of the three, as Butano picks it;
+ * "codec" is set to the one used (empty if uncompressed).
+ */
+inline int compressed_size(const std::vector<unsigned char> &data,
+                           const std::string &compression,
+                           std::string *codec = nullptr) {
+  std::string used = compression == "none" ? "" : compression;
+  int bytes = int(data.size());
+  if (used == "run_length") {
+    bytes = detail::run_length_size(data);
+  } else if (used == "lz77") {
+    bytes = detail::lz77_size(data);
+  } else if (used == "huffman") {
+    bytes = detail::huffman_size(data);
+  } else if (used == "auto") {
+    used = "run_length";
+    bytes = detail::run_length_size(data);
+    for (const char *other : {"lz77", "huffman"}) {
+      const int other_bytes = compressed_size(data, other);
+      if (other_bytes < bytes) {
+        used = other;
+        bytes = other_bytes;
+      }
+    }
+  }
+  if (codec != nullptr) {
+    *codec = used;
+  }
+  return bytes;
+}
+
+/**
+ * @brief Counts tiles, colours and bytes of one asset.
+ *
+ * Tiles are walked frame by frame, each frame in rows of 8x8 tiles, which is
+ * the order Butano stores sprite sheets in. Backgrounds are imported with
+ * flipped duplicates merged, so their ROM size uses unique tiles; sprites
+ * keep every tile, since a frame's tiles must be contiguous. Compressed
+ * sizes are estimated from that tile data and, for backgrounds, a map
+ * without flip bits; the palette is counted uncompressed.
+ */
+inline AssetStats analyze(const std::string &name, const Bitmap &bitmap,
+                          const AssetDescriptor &descriptor) {
+  AssetStats stats;
+  stats.name = name;
+  stats.type = descriptor.type;
+
+  std::set<int> used(bitmap.pixels.begin(), bitmap.pixels.end());
+  stats.colors = int(used.size());
+  stats.highest_index = used.empty() ? 0 : *used.rbegin();
+  // Index 0 stays transparent, so 15 opaque colours fit one bank.
+  stats.bpp4_eligible = int(used.size()) - int(used.count(0)) < BANK_COLORS;
+  const bool bpp4 = bitmap.bpp == 4 || descriptor.bpp_mode == "bpp_4_auto" ||
+                    descriptor.bpp_mode == "bpp_4_manual";
+  stats.bpp = bpp4 ? 4 : 8;
+  if (bitmap.bpp == 4) {
+    stats.palette = bitmap.colors;
+  }
+  const int palette_colors =
+      bpp4 ? BANK_COLORS
+           : (stats.highest_index / BANK_COLORS + 1) * BANK_COLORS;
+
+  if (descriptor.type == "sprite_palette") {
+    // Only the colour table matters; the pixels are a placeholder.
+    stats.colors = bitmap.palette_size;
+    stats.highest_index = bitmap.palette_size - 1;
+    stats.bpp4_eligible = bitmap.palette_size <= BANK_COLORS;
+    stats.rom_bytes = bitmap.palette_size * 2;
+    return stats;
+  }
+
+  const int frame_height =
+      descriptor.height > 0 ? descriptor.height : bitmap.height;
+  const int tiles_wide = bitmap.width / TILE_PIXELS;
+  const int frame_rows = frame_height / TILE_PIXELS;
+  stats.frames = bitmap.height / frame_height;
+  stats.frame_tiles = tiles_wide * frame_rows;
+  stats.tiles = stats.frame_tiles * stats.frames;
+
+  const bool compressed =
+      !descriptor.compression.empty() && descriptor.compression != "none";
+  std::vector<unsigned char> data;
+  std::vector<unsigned char> map;
+  std::vector<detail::Tile> unique_order;
+  std::set<detail::Tile> unique;
+  for (int frame = 0; frame < stats.frames; ++frame) {
+    for (int row = 0; row < frame_rows; ++row) {
+      for (int column = 0; column < tiles_wide; ++column) {
+        const detail::Tile tile =
+            detail::read_tile(bitmap, column, frame * frame_rows + row);
+        if (std::all_of(tile.begin(), tile.end(),
+                        [](unsigned char pixel) { return pixel == 0; })) {
+          ++stats.empty_tiles;
+        }
+        const detail::Tile canonical = detail::canonical(tile);
+        if (unique.insert(canonical).second) {
+          unique_order.push_back(canonical);
+        }
+        if (!compressed) {
+          continue;
+        }
+        if (descriptor.type == "regular_bg") {
+          const auto index = std::find(unique_order.begin(),
+                                       unique_order.end(), canonical) -
+                             unique_order.begin();
+          map.push_back(index & 0xff);
+          map.push_back(index >> 8);
+        } else {
+          detail::append_tile(tile, stats.bpp, data);
+        }
+      }
+    }
+  }
+  stats.unique_tiles = int(unique.size());
+
+  if (descriptor.type == "regular_bg") {
+    stats.raw_bytes = stats.unique_tiles * stats.tile_bytes() +
+                      stats.tiles * BG_MAP_ENTRY_BYTES + palette_colors * 2;
+  } else {
+    stats.raw_bytes = stats.tiles * stats.tile_bytes() + palette_colors * 2;
+  }
+  stats.rom_bytes = stats.raw_bytes;
+  if (compressed) {
+    if (descriptor.type == "regular_bg") {
+      for (const detail::Tile &tile : unique_order) {
+        detail::append_tile(tile, stats.bpp, data);
+      }
+    }
+    // Tiles and map are compressed separately, with the same codec.
+    stats.rom_bytes = compressed_size(data, descriptor.compression,
+                                      &stats.compression) +
+                      palette_colors * 2;
+    if (!map.empty()) {
+      stats.rom_bytes += compressed_size(map, stats.compression);
+    }
+  }
+  return stats;
+}
+
+/**
+ * @brief One asset in a scene and how many frames of it are in VRAM at
+ * once (e.g. one per sprite showing it, or one per text glyph).
+ */
+struct SceneUse {
+  std::string asset;
+  int frames_resident = 1;
+  int palettes = 1;  // 4bpp palettes it shows with (looks); 1 is its own
+};
+
+/**
+ * @brief Video memory a scene needs, against what the GBA has.
+ */
+struct SceneBudget {
+  int sprite_vram_bytes = 0;
+  int bg_vram_bytes = 0;
+  int palette_banks = 0;  // 8bpp colours rounded up to banks, + 4bpp ones
+  long long load_cycles = 0;  // unpacking compressed assets
+  std::vector<std::string> missing;  // SceneUse assets without stats
+  std::vector<std::string> slow_sprites;  // unpack longer than VBlank
+
+  [[nodiscard]] bool fits() const {
+    return missing.empty() && slow_sprites.empty() &&
+           sprite_vram_bytes <= SPRITE_VRAM_BYTES &&
+           bg_vram_bytes <= BG_VRAM_BYTES &&
+           palette_banks <= SPRITE_PALETTE_BANKS &&
+           load_cycles <= static_cast<long long>(LOAD_BUDGET_FRAMES) *
+                              FRAME_CYCLES;
+  }
+};
+
+/**
+ * @brief Adds up what "uses" keep in VRAM at once.
+ *
+ * Sprites cost their frame tiles per resident frame. Backgrounds cost all
+ * their unique tiles plus the map. All 8bpp sprites share palette entries
+ * from 0 up to the highest index any of them uses. 4bpp sprites shown with
+ * their own palette share a bank when the palettes are identical, as Butano
+ * does; each extra look takes a bank of its own. Compressed assets are
+ * unpacked once each, when the scene loads or a sprite is created.
+ */
+inline SceneBudget scene_budget(const std::vector<AssetStats> &assets,
+                                const std::vector<SceneUse> &uses) {
+  SceneBudget budget;
+  int bpp8_colors = 0;
+  std::set<std::vector<std::uint32_t>> bpp4_palettes;
+  for (const SceneUse &use : uses) {
+    auto stats = std::find_if(
+        assets.begin(), assets.end(),
+        [&](const AssetStats &asset) { return asset.name == use.asset; });
+    if (stats == assets.end()) {
+      budget.missing.push_back(use.asset);
+      continue;
+    }
+    budget.load_cycles += stats->decompress_cycles();
+    if (stats->type == "regular_bg") {
+      budget.bg_vram_bytes += stats->unique_tiles * stats->tile_bytes() +
+                              stats->tiles * BG_MAP_ENTRY_BYTES;
+      continue;
+    }
+    if (stats->decompress_cycles() > VBLANK_CYCLES) {
+      budget.slow_sprites.push_back(use.asset);
+    }
+    budget.sprite_vram_bytes +=
+        use.frames_resident * stats->frame_tiles * stats->tile_bytes();
+    if (stats->bpp == 4 && use.palettes == 1) {
+      bpp4_palettes.insert(stats->palette);
+    } else if (stats->bpp == 4) {
+      budget.palette_banks += use.palettes;
+    } else {
+      bpp8_colors = std::max(bpp8_colors, stats->highest_index + 1);
+    }
+  }
+  budget.palette_banks += int(bpp4_palettes.size()) +
+                          (bpp8_colors + BANK_COLORS - 1) / BANK_COLORS;
+  return budget;
+}
+
+}  // namespace ti
+
+#endif
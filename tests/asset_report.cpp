@@ -0,0 +1,128 @@
+// asset_report.cpp
+// Prints ROM, VRAM and palette use of every asset in graphics/ and checks
+// that the scene main() builds fits the GBA, including the time it takes to
+// unpack compressed assets. Registered with CTest as "assets"; exits
+// non-zero if an asset can't be read or used as compressed, or the scene
+// overflows.
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "asset_analyzer.h"
+#include "ti_crowd_sim.h"
+
+namespace {
+// One customer to start with, plus one per wishlist upgrade bought.
+constexpr int CUSTOMERS_AT_FULL_POPULARITY = 10;
+
+// Glyphs of the wishlist, its prices and the cash counter, which the text
+// generator keeps as one tile each.
+constexpr int TEXT_GLYPHS = 96;
+
+// What main() keeps on screen once every upgrade is bought. Each entry holds
+// one frame of VRAM per sprite showing it; sprites on the same frame of the
+// same sheet share it, so e.g. every shadow counts once.
+std::vector<ti::SceneUse> main_scene() {
+  std::vector<ti::SceneUse> scene = {
+      {"bg1"},       {"overlay"},   {"popularity_bar"}, {"cursor"},
+      {"title"},     {"steam"},     {"barista"},        {"drinker"},
+      {"talkative"}, {"pigeon"},    {"pigeon2"},        {"till"},
+      {"cash"},      {"twinkle"},   {"reflect"},        {"blocker"},
+      {"clock"},     {"cookies"},   {"bonsai"},         {"vines"},
+      {"topiary"},   {"painting"},  {"cactus1"},        {"sylvester"},
+      {"typist"},    {"shadow"},
+  };
+  // The wishlist's text generator draws the font with the black palette and
+  // the cash counter with the white one; the font's own palette is the
+  // black one.
+  scene.push_back({"font", TEXT_GLYPHS});
+  scene.push_back({"black_text_palette"});
+  scene.push_back({"white_text_palette"});
+  // Every customer streams its frame into a slot of its own (see
+  // ti::Person), whichever body it wears, and wears one of the looks in
+  // play, however many customers there are. A respawn loads its next look
+  // before letting go of the old one.
+  scene.push_back({"customer_body_a", CUSTOMERS_AT_FULL_POPULARITY,
+                   ti::CrowdSim::MAX_LOOKS_IN_PLAY + 1});
+  return scene;
+}
+
+std::string read_text(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  std::stringstream text;
+  text << file.rdbuf();
+  return text.str();
+}
+}  // namespace
+
+int main() {
+  std::vector<std::filesystem::path> descriptors;
+  for (const auto& entry : std::filesystem::directory_iterator(GRAPHICS_DIR)) {
+    if (entry.path().extension() == ".json") {
+      descriptors.push_back(entry.path());
+    }
+  }
+  std::sort(descriptors.begin(), descriptors.end());
+
+  bool ok = true;
+  std::vector<ti::AssetStats> assets;
+  int rom_bytes = 0;
+  std::printf("%-18s %-14s %3s %6s %6s %6s %6s %6s %4s %-10s %6s\n", "asset",
+              "type", "bpp", "frames", "tiles", "unique", "empty", "colors",
+              "4bpp", "compress", "rom");
+  for (const std::filesystem::path& json : descriptors) {
+    std::filesystem::path bmp = json;
+    bmp.replace_extension(".bmp");
+    ti::Bitmap bitmap;
+    if (!ti::read_bmp(bmp.string(), bitmap)) {
+      std::printf("%s: not an indexed 4/8bpp BMP\n", bmp.string().c_str());
+      ok = false;
+      continue;
+    }
+    const ti::AssetStats stats =
+        ti::analyze(json.stem().string(), bitmap,
+                    ti::parse_descriptor(read_text(json)));
+    std::printf("%-18s %-14s %3d %6d %6d %6d %6d %6d %4s %-10s %6d\n",
+                stats.name.c_str(), stats.type.c_str(), stats.bpp,
+                stats.frames, stats.tiles, stats.unique_tiles,
+                stats.empty_tiles, stats.colors,
+                stats.bpp == 4 ? "yes" : stats.bpp4_eligible ? "can" : "no",
+                stats.compression.empty() ? "-" : stats.compression.c_str(),
+                stats.rom_bytes);
+    if (!stats.compression_supported()) {
+      std::printf("%s: sprite sheets with more than one frame must stay "
+                  "uncompressed\n",
+                  stats.name.c_str());
+      ok = false;
+    }
+    rom_bytes += stats.rom_bytes;
+    assets.push_back(stats);
+  }
+  std::printf("graphics in ROM: %d bytes\n\n", rom_bytes);
+
+  const ti::SceneBudget budget = ti::scene_budget(assets, main_scene());
+  std::printf("main scene, %d customers:\n", CUSTOMERS_AT_FULL_POPULARITY);
+  std::printf("  sprite VRAM  %6d of %6d bytes\n", budget.sprite_vram_bytes,
+              ti::SPRITE_VRAM_BYTES);
+  std::printf("  bg VRAM      %6d of %6d bytes\n", budget.bg_vram_bytes,
+              ti::BG_VRAM_BYTES);
+  std::printf("  palettes     %6d of %6d banks\n", budget.palette_banks,
+              ti::SPRITE_PALETTE_BANKS);
+  std::printf("  unpacking    %6lld of %6d cycles\n", budget.load_cycles,
+              ti::LOAD_BUDGET_FRAMES * ti::FRAME_CYCLES);
+  for (const std::string& missing : budget.missing) {
+    std::printf("  missing asset: %s\n", missing.c_str());
+  }
+  for (const std::string& slow : budget.slow_sprites) {
+    std::printf("  %s takes longer than VBlank to unpack\n", slow.c_str());
+  }
+  if (!budget.fits()) {
+    std::printf("main scene does not fit\n");
+    ok = false;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Compare Catch2 benchmark results against a checked-in baseline.
+
+Reads the XML reporter output of bench_hot_paths (``-r xml``), which both
+Catch2 2.x and 3.x write in the same shape, and compares each benchmark's
+mean time with baseline.json. A single run's mean varies by up to about 50%
+on a busy machine, so pass several reports of repeated runs: each benchmark
+is taken at its fastest mean across them, which is stable enough to gate on
+a 25% slowdown.
+
+    compare_bench.py run*.xml baseline.json          # report, exit 1 on
+                                                     # regressions
+    compare_bench.py run*.xml baseline.json --write  # refresh baseline
+"""
+
+import argparse
+import json
+import sys
+import xml.etree.ElementTree as ElementTree
+
+
+def read_results(paths):
+    """Return {benchmark name: fastest mean nanoseconds} over Catch2 XML
+    reports."""
+    results = {}
+    for path in paths:
+        for benchmark in ElementTree.parse(path).iter("BenchmarkResults"):
+            name = benchmark.get("name")
+            mean = float(benchmark.find("mean").get("value"))
+            results[name] = min(mean, results.get(name, mean))
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("results", nargs="+",
+                        help="Catch2 XML reports of repeated runs")
+    parser.add_argument("baseline", help="baseline JSON file")
+    parser.add_argument("--tolerance", type=float, default=0.25,
+                        help="allowed slowdown as a fraction (default 0.25)")
+    parser.add_argument("--write", action="store_true",
+                        help="overwrite the baseline with these results")
+    args = parser.parse_args()
+
+    results = read_results(args.results)
+    if not results:
+        sys.exit(f"no benchmarks found in {' '.join(args.results)}")
+
+    if args.write:
+        with open(args.baseline, "w") as baseline_file:
+            json.dump({"unit": "ns", "benchmarks": results}, baseline_file,
+                      indent=2, sort_keys=True)
+            baseline_file.write("\n")
+        print(f"wrote {len(results)} benchmarks from {len(args.results)} "
+              f"run(s) to {args.baseline}")
+        return
+
+    with open(args.baseline) as baseline_file:
+        baseline = json.load(baseline_file)["benchmarks"]
+
+    regressions = 0
+    print(f"{'benchmark':<52} {'baseline':>10} {'now':>10} {'ratio':>7}")
+    for name, mean in sorted(results.items()):
+        if name not in baseline:
+            print(f"{name:<52} {'-':>10} {mean:>10.1f}     new")
+            continue
+        ratio = mean / baseline[name]
+        flag = ""
+        if ratio > 1 + args.tolerance:
+            flag = "  REGRESSED"
+            regressions += 1
+        print(f"{name:<52} {baseline[name]:>10.1f} {mean:>10.1f} "
+              f"{ratio:>6.2f}x{flag}")
+    for name in sorted(set(baseline) - set(results)):
+        print(f"{name:<52} {baseline[name]:>10.1f} {'-':>10}  missing")
+
+    if regressions:
+        sys.exit(f"{regressions} benchmark(s) slower than baseline by more "
+                 f"than {args.tolerance:.0%}")
+
+
+if __name__ == "__main__":
+    main()
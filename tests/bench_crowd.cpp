@@ -0,0 +1,30 @@
+// bench_crowd.cpp
+// Host macro-benchmarks for the crowd simulation using Catch2 BENCHMARK.
+
+#include <catch2/catch_all.hpp>
+
+#include "ti_crowd_sim.h"
+
+namespace {
+constexpr int kCustomers = 16;
+}  // namespace
+
+TEST_CASE("CrowdSim: frames at full popularity", "[benchmark]") {
+  ti::CrowdSim crowd;
+  for (int i = 0; i < kCustomers; i++) {
+    crowd.add_person(i % 2 == 0 ? ti::START::RIGHT : ti::START::LEFT,
+                     ti::TYPE::GREEN_SHIRT);
+  }
+  // Warm up so the queue, counter and street are all in use.
+  for (int frame = 0; frame < 60 * 60; frame++) {
+    crowd.update(kCustomers);
+  }
+
+  BENCHMARK("CrowdSim::update x 60 frames, 16 customers") {
+    int purchases = 0;
+    for (int frame = 0; frame < 60; frame++) {
+      purchases += crowd.update(kCustomers);
+    }
+    return purchases;
+  };
+}
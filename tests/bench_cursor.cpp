@@ -0,0 +1,33 @@
+// bench_cursor.cpp
+// Host benchmarks for wishlist cursor movement using Catch2 BENCHMARK.
+
+#include <catch2/catch_all.hpp>
+#include <vector>
+
+#include "cursor_helpers.h"
+
+TEST_CASE("move_cursor: wishlist navigation", "[benchmark]") {
+  // The nine wishlist prices from main(), early and late in a game.
+  const std::vector<int> fresh = {30, 15, 70, 20, 40, 55, 22, 100, 125};
+  const std::vector<int> late = {0, 0, 70, 0, 0, 0, 0, 100, 0};
+
+  BENCHMARK("ti::move_cursor down and up, nothing bought") {
+    int index = 0;
+    for (int i = 0; i < 8; i++) {
+      index = ti::move_cursor(index, +1, fresh);
+    }
+    for (int i = 0; i < 8; i++) {
+      index = ti::move_cursor(index, -1, fresh);
+    }
+    return index;
+  };
+
+  BENCHMARK("ti::move_cursor down and up, mostly bought") {
+    int index = 2;
+    for (int i = 0; i < 8; i++) {
+      index = ti::move_cursor(index, +1, late);
+      index = ti::move_cursor(index, -1, late);
+    }
+    return index;
+  };
+}
@@ -0,0 +1,84 @@
+// bench_movement.cpp
+// Host benchmarks for the per-frame movement kernel using Catch2 BENCHMARK.
+// Compares the table-driven ti::get_next_step with the original trig version
+// and times a full frame of 16 walkers touring the cafe's real waypoints.
+
+#include <catch2/catch_all.hpp>
+
+#include "reference_movement.h"
+#include "ti_cafe_layout.h"
+#include "ti_helpers.h"
+
+namespace {
+// Walker positions and targets spread over the cafe's waypoints.
+const bn::fixed_point kFrom[] = {
+    bn::fixed_point(-160, 55), bn::fixed_point(160, 62),
+    bn::fixed_point(100, 60),  bn::fixed_point(88, 36),
+    bn::fixed_point(0, 24),    bn::fixed_point(-45, 21),
+    bn::fixed_point(-66, 14),  bn::fixed_point(-100, 16),
+};
+const bn::fixed_point kTo[] = {
+    bn::fixed_point(100, 60),  bn::fixed_point(100, 60),
+    bn::fixed_point(88, 36),   bn::fixed_point(0, 24),
+    bn::fixed_point(-60, 12),  bn::fixed_point(-60, 12),
+    bn::fixed_point(-100, 16), bn::fixed_point(88, 36),
+};
+constexpr int kWalkers = sizeof(kFrom) / sizeof(kFrom[0]);
+
+// A customer's full visit, in the order PersonSim walks it.
+const bn::fixed_point kRoute[] = {
+    ti::CAFE_LAYOUT.right,       ti::CAFE_LAYOUT.outside,
+    ti::CAFE_LAYOUT.door,        ti::CAFE_LAYOUT.queue_start,
+    ti::CAFE_LAYOUT.till,        ti::CAFE_LAYOUT.queue_front,
+    ti::CAFE_LAYOUT.counter1,    ti::CAFE_LAYOUT.door,
+    ti::CAFE_LAYOUT.outside,     ti::CAFE_LAYOUT.left,
+};
+constexpr int kRouteLength = sizeof(kRoute) / sizeof(kRoute[0]);
+constexpr int kCrowdWalkers = 16;
+
+struct Walker {
+  bn::fixed_point position;
+  int leg;
+};
+}  // namespace
+
+TEST_CASE("get_next_step: table kernel vs trig", "[benchmark]") {
+  BENCHMARK("ti::get_next_step (direction table)") {
+    bn::fixed sum = 0;
+    for (int i = 0; i < kWalkers; i++) {
+      bn::fixed_point next = ti::get_next_step(kFrom[i], kTo[i], 0.3);
+      sum += next.x() + next.y();
+    }
+    return sum;
+  };
+
+  BENCHMARK("reference::get_next_step_trig (atan2 + sin/cos)") {
+    bn::fixed sum = 0;
+    for (int i = 0; i < kWalkers; i++) {
+      bn::fixed_point next =
+          reference::get_next_step_trig(kFrom[i], kTo[i], 0.3);
+      sum += next.x() + next.y();
+    }
+    return sum;
+  };
+}
+
+TEST_CASE("get_next_step: one frame of a full crowd", "[benchmark]") {
+  // Walkers start spread along the route so every leg is exercised.
+  Walker walkers[kCrowdWalkers];
+  for (int i = 0; i < kCrowdWalkers; i++) {
+    walkers[i] = {kRoute[i % kRouteLength], (i + 1) % kRouteLength};
+  }
+
+  BENCHMARK("16 walkers x ti::get_next_step") {
+    for (Walker& walker : walkers) {
+      const bn::fixed_point& target = kRoute[walker.leg];
+      walker.position = ti::get_next_step(walker.position, target, 0.3);
+      if (walker.position.x() == target.x() &&
+          walker.position.y() == target.y()) {
+        walker.leg = (walker.leg + 1) % kRouteLength;
+      }
+    }
+    return walkers[0].position.x();
+  };
+}
@@ -1,68 +1,136 @@
 /**
  * Simple Butano stand-ins so host-side unit tests can compile production
  * helpers without pulling the real devkitARM dependencies.
+ *
+ * bn::fixed is bit-exact with the ROM's Q12 arithmetic; trig is table-based
+ * like Butano's but not guaranteed to match it bit for bit (see host_trig).
  */
 #pragma once
 
 #include <cmath>
+#include <deque>
 #include <utility>
+#include <vector>
 
 namespace bn {
 
+/**
+ * Q12 fixed-point number with the same representation and arithmetic as
+ * Butano's bn::fixed (bn::fixed_t<12>): a 32-bit integer scaled by 4096,
+ * 64-bit intermediate products shifted right (rounding toward negative
+ * infinity), truncating division and float conversion, and no implicit
+ * conversion back to float.
+ */
 class fixed {
  public:
+  static constexpr int PRECISION = 12;
+
   constexpr fixed() = default;
-  constexpr fixed(float value) : _value(value) {}
-  constexpr fixed(int value) : _value(static_cast<float>(value)) {}
+  constexpr fixed(int value) : _data(value * (1 << PRECISION)) {}
+  constexpr fixed(float value) : _data(int(value * (1 << PRECISION))) {}
+  constexpr fixed(double value) : _data(int(value * (1 << PRECISION))) {}
+
+  [[nodiscard]] static constexpr fixed from_data(int data) {
+    fixed result;
+    result._data = data;
+    return result;
+  }
 
-  constexpr operator float() const { return _value; }
+  [[nodiscard]] static constexpr int precision() { return PRECISION; }
+  [[nodiscard]] static constexpr int scale() { return 1 << PRECISION; }
 
-  [[nodiscard]] constexpr int integer() const {
-    return static_cast<int>(_value);
+  [[nodiscard]] constexpr int data() const { return _data; }
+
+  /** Integer part, truncated toward zero like Butano's integer(). */
+  [[nodiscard]] constexpr int integer() const { return _data / scale(); }
+
+  [[nodiscard]] constexpr int right_shift_integer() const {
+    return _data >> PRECISION;
   }
 
-  fixed& operator+=(fixed other) {
-    _value += other._value;
-    return *this;
+  [[nodiscard]] constexpr int round_integer() const {
+    return (_data + scale() / 2) >> PRECISION;
+  }
+
+  [[nodiscard]] constexpr float to_float() const {
+    return float(_data) / scale();
+  }
+
+  [[nodiscard]] constexpr double to_double() const {
+    return double(_data) / scale();
+  }
+
+  [[nodiscard]] constexpr fixed multiplication(fixed other) const {
+    return from_data(int((static_cast<long long>(_data) * other._data) >>
+                         PRECISION));
   }
 
-  fixed& operator-=(fixed other) {
-    _value -= other._value;
+  [[nodiscard]] constexpr fixed division(fixed other) const {
+    return from_data(
+        int((static_cast<long long>(_data) << PRECISION) / other._data));
+  }
+
+  constexpr fixed& operator+=(fixed other) {
+    _data += other._data;
     return *this;
   }
 
-  fixed& operator*=(fixed other) {
-    _value *= other._value;
+  constexpr fixed& operator-=(fixed other) {
+    _data -= other._data;
     return *this;
   }
 
-  fixed& operator/=(fixed other) {
-    _value /= other._value;
+  constexpr fixed& operator*=(fixed other) {
+    *this = multiplication(other);
     return *this;
   }
 
-  friend fixed operator+(fixed lhs, fixed rhs) {
-    return fixed(lhs._value + rhs._value);
+  constexpr fixed& operator*=(int value) {
+    _data *= value;
+    return *this;
   }
 
-  friend fixed operator-(fixed lhs, fixed rhs) {
-    return fixed(lhs._value - rhs._value);
+  constexpr fixed& operator/=(fixed other) {
+    *this = division(other);
+    return *this;
   }
 
-  friend fixed operator*(fixed lhs, fixed rhs) {
-    return fixed(lhs._value * rhs._value);
+  constexpr fixed& operator/=(int value) {
+    _data /= value;
+    return *this;
   }
 
-  friend fixed operator*(fixed lhs, int rhs) { return fixed(lhs._value * rhs); }
+  [[nodiscard]] constexpr fixed operator-() const { return from_data(-_data); }
 
-  friend fixed operator*(int lhs, fixed rhs) { return fixed(lhs * rhs._value); }
+  friend constexpr fixed operator+(fixed a, fixed b) { return a += b; }
+  friend constexpr fixed operator-(fixed a, fixed b) { return a -= b; }
+  friend constexpr fixed operator*(fixed a, fixed b) { return a *= b; }
+  friend constexpr fixed operator*(fixed a, int b) { return a *= b; }
+  friend constexpr fixed operator*(int a, fixed b) { return b *= a; }
+  friend constexpr fixed operator/(fixed a, fixed b) { return a /= b; }
+  friend constexpr fixed operator/(fixed a, int b) { return a /= b; }
 
-  friend fixed operator/(fixed lhs, fixed rhs) {
-    return fixed(lhs._value / rhs._value);
+  friend constexpr bool operator==(fixed a, fixed b) {
+    return a._data == b._data;
+  }
+  friend constexpr bool operator!=(fixed a, fixed b) {
+    return a._data != b._data;
+  }
+  friend constexpr bool operator<(fixed a, fixed b) {
+    return a._data < b._data;
+  }
+  friend constexpr bool operator>(fixed a, fixed b) {
+    return a._data > b._data;
+  }
+  friend constexpr bool operator<=(fixed a, fixed b) {
+    return a._data <= b._data;
+  }
+  friend constexpr bool operator>=(fixed a, fixed b) {
+    return a._data >= b._data;
   }
 
  private:
-  float _value = 0;
+  int _data = 0;
 };
 
 template <typename First, typename Second>
@@ -75,25 +143,162 @@ class fixed_point {
   [[nodiscard]] constexpr fixed x() const { return _x; }
   [[nodiscard]] constexpr fixed y() const { return _y; }
 
+  void set_x(fixed x) { _x = x; }
+  void set_y(fixed y) { _y = y; }
+
+  friend bool operator==(const fixed_point &a, const fixed_point &b) {
+    return a._x == b._x && a._y == b._y;
+  }
+
+  friend bool operator!=(const fixed_point &a, const fixed_point &b) {
+    return !(a == b);
+  }
+
  private:
   fixed _x;
   fixed _y;
 };
 
-inline fixed abs(fixed value) {
-  return fixed(std::fabs(static_cast<float>(value)));
+constexpr fixed abs(fixed value) { return value < 0 ? -value : value; }
+
+namespace host_trig {
+// Lookup tables in the spirit of Butano's sin_lut: Q12 values, 2048 steps
+// per turn for sine, and 256 steps of atan over the first octant. Entries
+// are rounded once from libm, so results are deterministic and quantized
+// like the ROM's table trig; they are not guaranteed to match bn_math.cpp
+// bit for bit.
+constexpr int SIN_STEPS = 2048;
+constexpr int ATAN_STEPS = 256;
+
+struct Tables {
+  short sin[SIN_STEPS + 1];
+  int atan_degrees[ATAN_STEPS + 1];  // Q12 degrees, 0..45
+
+  Tables() {
+    const double pi = std::acos(-1.0);
+    for (int i = 0; i <= SIN_STEPS; ++i) {
+      sin[i] = short(std::lround(std::sin(2 * pi * i / SIN_STEPS) * 4096));
+    }
+    for (int i = 0; i <= ATAN_STEPS; ++i) {
+      atan_degrees[i] = int(
+          std::lround(std::atan(double(i) / ATAN_STEPS) * 180 / pi * 4096));
+    }
+  }
+};
+
+inline const Tables& tables() {
+  static const Tables instance;
+  return instance;
 }
+}  // namespace host_trig
 
+/** Degrees in (-180, 180] of the vector (x, y), from the octant table. */
 inline fixed degrees_atan2(int y, int x) {
-  constexpr float kRadToDeg = 180.0f / 3.1415926535f;
-  return fixed(std::atan2(static_cast<float>(y), static_cast<float>(x)) *
-               kRadToDeg);
+  if (x == 0 && y == 0) {
+    return 0;
+  }
+  long long ax = x < 0 ? -static_cast<long long>(x) : x;
+  long long ay = y < 0 ? -static_cast<long long>(y) : y;
+  bool steep = ay > ax;
+  long long major = steep ? ay : ax;
+  long long minor = steep ? ax : ay;
+  // Linear interpolation between table entries, in 1/4096ths of a step.
+  long long position = (minor * host_trig::ATAN_STEPS << 12) / major;
+  int index = int(position >> 12);
+  int fraction = int(position & 4095);
+  const int* atan_degrees = host_trig::tables().atan_degrees;
+  int degrees = atan_degrees[index];
+  if (index < host_trig::ATAN_STEPS) {
+    degrees += int((static_cast<long long>(atan_degrees[index + 1] - degrees) *
+                    fraction) >>
+                   12);
+  }
+  if (steep) {
+    degrees = 90 * 4096 - degrees;
+  }
+  if (x < 0) {
+    degrees = 180 * 4096 - degrees;
+  }
+  if (y < 0) {
+    degrees = -degrees;
+  }
+  return fixed::from_data(degrees);
 }
 
+/** Sine and cosine of an angle in degrees, nearest entry of the table. */
 inline pair<fixed, fixed> degrees_sin_and_cos(fixed degrees) {
-  constexpr float kDegToRad = 3.1415926535f / 180.0f;
-  float radians = static_cast<float>(degrees) * kDegToRad;
-  return {fixed(std::sin(radians)), fixed(std::cos(radians))};
+  constexpr long long full_turn = 360LL << fixed::PRECISION;
+  long long angle = degrees.data() % full_turn;
+  if (angle < 0) {
+    angle += full_turn;
+  }
+  int step = int((angle * host_trig::SIN_STEPS + full_turn / 2) / full_turn);
+  int cos_step = (step + host_trig::SIN_STEPS / 4) % host_trig::SIN_STEPS;
+  const host_trig::Tables& tables = host_trig::tables();
+  return {fixed::from_data(tables.sin[step]),
+          fixed::from_data(tables.sin[cos_step])};
 }
 
+/**
+ * Fixed-capacity containers backed by the standard library. Capacity is not
+ * enforced; Butano asserts on overflow, the host build simply grows.
+ */
+template <typename Type, int MaxSize>
+class vector : public std::vector<Type> {
+ public:
+  using std::vector<Type>::vector;
+
+  [[nodiscard]] int size() const {
+    return static_cast<int>(std::vector<Type>::size());
+  }
+
+  [[nodiscard]] constexpr int max_size() const { return MaxSize; }
+
+  [[nodiscard]] bool full() const { return size() >= MaxSize; }
+};
+
+template <typename Type, int MaxSize>
+class deque : public std::deque<Type> {
+ public:
+  using std::deque<Type>::deque;
+
+  [[nodiscard]] int size() const {
+    return static_cast<int>(std::deque<Type>::size());
+  }
+
+  [[nodiscard]] constexpr int max_size() const { return MaxSize; }
+
+  [[nodiscard]] bool full() const { return size() >= MaxSize; }
+};
+
+/**
+ * Xorshift32 generator with the same interface as Butano's bn::random.
+ */
+class random {
+ public:
+  constexpr random() = default;
+
+  [[nodiscard]] constexpr unsigned seed() const { return _seed; }
+
+  constexpr void set_seed(unsigned seed) { _seed = seed; }
+
+  unsigned get() {
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+    return _seed;
+  }
+
+  [[nodiscard]] int get_int(int limit) {
+    return static_cast<int>(get() % static_cast<unsigned>(limit));
+  }
+
+  [[nodiscard]] fixed get_fixed(fixed limit) {
+    return fixed::from_data(get_int(limit.data()));
+  }
+
+ private:
+  unsigned _seed = 123456789;
+};
+
 }  // namespace bn
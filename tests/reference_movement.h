@@ -0,0 +1,29 @@
+// reference_movement.h
+// The original atan2 + sin/cos movement step, kept for equivalence tests and
+// benchmarks against ti::get_next_step.
+
+#pragma once
+
+#include "bn_fixed_point.h"
+#include "bn_math.h"
+
+namespace reference {
+
+inline bn::fixed_point get_next_step_trig(const bn::fixed_point& from,
+                                          const bn::fixed_point& to,
+                                          bn::fixed speed) {
+  bn::fixed diff_x = from.x() - to.x();
+  bn::fixed diff_y = from.y() - to.y();
+
+  if (bn::abs(diff_x) > 2 || bn::abs(diff_y) > 2) {
+    bn::fixed angle = bn::degrees_atan2(diff_y.integer(), diff_x.integer());
+    bn::pair<bn::fixed, bn::fixed> xy = bn::degrees_sin_and_cos(angle);
+
+    return bn::fixed_point(from.x() - speed * xy.second,
+                           from.y() - speed * xy.first);
+  }
+
+  return to;
+}
+
+}  // namespace reference
@@ -0,0 +1,79 @@
+// test_anim_clips.cpp
+// Unit tests for the constexpr customer clip table and ClipPlayer.
+
+#include <catch2/catch_all.hpp>
+#include <vector>
+
+#include "ti_anim_clips.h"
+
+namespace {
+// Model of bn::sprite_animate_action::update(): the first update shows the
+// first index, then each index holds for wait_updates further updates.
+std::vector<int> animate_action_frames(int wait_updates,
+                                       const std::vector<int>& indexes,
+                                       int updates) {
+  std::vector<int> shown;
+  int current = 0;
+  int wait = 0;
+  int frame = -1;
+  for (int i = 0; i < updates; i++) {
+    if (wait == 0) {
+      frame = indexes[current];
+      current = (current + 1) % int(indexes.size());
+      wait = wait_updates;
+    } else {
+      --wait;
+    }
+    shown.push_back(frame);
+  }
+  return shown;
+}
+}  // namespace
+
+TEST_CASE("ClipPlayer: frames match the old sprite_animate_action clips",
+          "[anim]") {
+  struct Case {
+    ti::CLIP clip;
+    int wait_updates;
+    std::vector<int> indexes;
+  };
+  const Case cases[] = {
+      {ti::CLIP::WALK, 12, {0, 1, 2, 3, 4, 5, 6, 7}},
+      {ti::CLIP::WALK_W_COFFEE, 12, {8, 9, 10, 11, 12, 13, 14, 15}},
+      {ti::CLIP::IDLE, 20, {16, 16, 16, 16, 17, 17, 17, 17}},
+  };
+  for (const Case& c : cases) {
+    std::vector<int> expected =
+        animate_action_frames(c.wait_updates, c.indexes, 1000);
+    ti::ClipPlayer player;
+    constexpr int kStart = 12345;
+    player.play(c.clip, kStart);
+    for (int i = 0; i < 1000; i++) {
+      INFO("clip " << int(c.clip) << " update " << i);
+      REQUIRE(player.frame(kStart + i) == expected[i]);
+    }
+  }
+}
+
+TEST_CASE("ClipPlayer: re-requesting the playing clip does not restart",
+          "[anim]") {
+  ti::ClipPlayer player;
+  REQUIRE(player.play(ti::CLIP::WALK, 0));
+  REQUIRE(player.frame(13 * 3) == 3);
+  REQUIRE_FALSE(player.play(ti::CLIP::WALK, 13 * 3));
+  REQUIRE(player.frame(13 * 3) == 3);
+
+  REQUIRE(player.play(ti::CLIP::IDLE, 100));
+  REQUIRE(player.frame(100) == 16);
+  REQUIRE(player.clip() == ti::CLIP::IDLE);
+}
+
+TEST_CASE("CUSTOMER_CLIPS: usable at compile time", "[anim]") {
+  constexpr ti::ClipPlayer player = [] {
+    ti::ClipPlayer p;
+    p.play(ti::CLIP::WALK_W_COFFEE, 0);
+    return p;
+  }();
+  static_assert(player.frame(13 * 2) == 10, "Frame must be constexpr.");
+  REQUIRE(ti::clip_data(ti::CLIP::IDLE).frame_count == 2);
+}
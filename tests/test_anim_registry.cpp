@@ -0,0 +1,56 @@
+// test_anim_registry.cpp
+// Unit tests for AnimRegistry, which suspends animations of hidden sprites.
+
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+
+#include "ti_anim_registry.h"
+
+namespace {
+// Steps the registry once and returns the ids it visited, finishing "done".
+std::vector<int> step(ti::AnimRegistry<8>& registry, int done = -1) {
+  std::vector<int> visited;
+  registry.step([&](int id) {
+    visited.push_back(id);
+    return id == done;
+  });
+  return visited;
+}
+}  // namespace
+
+TEST_CASE("AnimRegistry: steps playing animations until they are done") {
+  ti::AnimRegistry<8> registry;
+  REQUIRE(step(registry).empty());
+
+  registry.play(5);
+  registry.play(1);
+  REQUIRE(step(registry) == std::vector<int>{1, 5});
+
+  REQUIRE(step(registry, 5) == std::vector<int>{1, 5});
+  REQUIRE_FALSE(registry.playing(5));
+  REQUIRE(step(registry) == std::vector<int>{1});
+
+  registry.stop(1);
+  REQUIRE(step(registry).empty());
+}
+
+TEST_CASE("AnimRegistry: hidden animations are skipped and resume as shown") {
+  ti::AnimRegistry<8> registry;
+  registry.play(0);
+  registry.play(7);
+  registry.set_visible(7, false);
+  REQUIRE(registry.playing(7));
+  REQUIRE(registry.suspended(7));
+  REQUIRE_FALSE(registry.running(7));
+  REQUIRE(step(registry) == std::vector<int>{0});
+
+  // Starting a hidden animation does not make it run either.
+  registry.set_visible(3, false);
+  registry.play(3);
+  REQUIRE(step(registry) == std::vector<int>{0});
+
+  registry.set_visible(7, true);
+  REQUIRE(registry.running(7));
+  REQUIRE(step(registry) == std::vector<int>{0, 7});
+}
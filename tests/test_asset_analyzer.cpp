@@ -0,0 +1,216 @@
+// test_asset_analyzer.cpp
+// Unit tests for the host-side asset statistics behind asset_report.
+
+#include <catch2/catch_all.hpp>
+
+#include "asset_analyzer.h"
+
+namespace {
+// A "width" x "height" bitmap of index 0 with "paint" applied per pixel.
+template <typename Paint>
+ti::Bitmap make_bitmap(int width, int height, Paint paint) {
+  ti::Bitmap bitmap;
+  bitmap.width = width;
+  bitmap.height = height;
+  bitmap.bpp = 8;
+  bitmap.palette_size = 256;
+  bitmap.pixels.resize(width * height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      bitmap.pixels[y * width + x] = paint(x, y);
+    }
+  }
+  return bitmap;
+}
+
+ti::AssetDescriptor sprite(int height) {
+  ti::AssetDescriptor descriptor;
+  descriptor.type = "sprite";
+  descriptor.height = height;
+  return descriptor;
+}
+}  // namespace
+
+TEST_CASE("parse_descriptor reads the fields Butano uses") {
+  const ti::AssetDescriptor descriptor = ti::parse_descriptor(
+      "{\n  \"type\": \"sprite\",\n  \"height\": 32,\n"
+      "  \"bpp_mode\": \"bpp_4_auto\"\n}\n");
+  REQUIRE(descriptor.type == "sprite");
+  REQUIRE(descriptor.height == 32);
+  REQUIRE(descriptor.bpp_mode == "bpp_4_auto");
+  REQUIRE(descriptor.compression.empty());
+
+  REQUIRE(ti::parse_descriptor("{\"type\":\"regular_bg\"}").height == 0);
+}
+
+TEST_CASE("analyze merges flipped duplicate tiles and counts empty ones") {
+  // Frame 0: a diagonal tile and its mirror image. Frame 1: empty, then a
+  // tile of a colour that appears nowhere else.
+  ti::Bitmap bitmap = make_bitmap(16, 16, [](int x, int y) {
+    if (y < 8) {
+      return x < 8 ? (x == y ? 3 : 0) : (15 - x == y ? 3 : 0);
+    }
+    return x < 8 ? 0 : 40;
+  });
+  const ti::AssetStats stats = ti::analyze("test", bitmap, sprite(8));
+  REQUIRE(stats.frames == 2);
+  REQUIRE(stats.frame_tiles == 2);
+  REQUIRE(stats.tiles == 4);
+  REQUIRE(stats.unique_tiles == 3);
+  REQUIRE(stats.empty_tiles == 1);
+  REQUIRE(stats.colors == 3);
+  REQUIRE(stats.highest_index == 40);
+  REQUIRE(stats.bpp4_eligible);
+  // Sprites keep every tile: 4 tiles of 64 bytes, 48 palette entries.
+  REQUIRE(stats.rom_bytes == 4 * 64 + 48 * 2);
+}
+
+TEST_CASE("analyze only calls 15 opaque colours 4bpp-eligible") {
+  ti::Bitmap fifteen = make_bitmap(8, 8, [](int x, int y) {
+    return (y * 8 + x) % 16;
+  });
+  REQUIRE(ti::analyze("test", fifteen, sprite(8)).bpp4_eligible);
+  ti::Bitmap sixteen = make_bitmap(8, 8, [](int x, int y) {
+    return 1 + (y * 8 + x) % 16;
+  });
+  REQUIRE_FALSE(ti::analyze("test", sixteen, sprite(8)).bpp4_eligible);
+}
+
+TEST_CASE("scene_budget adds frames, backgrounds and palette banks") {
+  ti::AssetStats body;
+  body.name = "body";
+  body.type = "sprite";
+  body.bpp = 4;
+  body.frame_tiles = 16;
+  ti::AssetStats prop;
+  prop.name = "prop";
+  prop.type = "sprite";
+  prop.frame_tiles = 4;
+  prop.highest_index = 19;
+  ti::AssetStats map;
+  map.name = "map";
+  map.type = "regular_bg";
+  map.tiles = 1024;
+  map.unique_tiles = 100;
+
+  const ti::SceneBudget budget = ti::scene_budget(
+      {body, prop, map}, {{"body", 10, 5}, {"prop"}, {"map"}});
+  REQUIRE(budget.sprite_vram_bytes == 10 * 16 * 32 + 4 * 64);
+  REQUIRE(budget.bg_vram_bytes == 100 * 64 + 1024 * 2);
+  REQUIRE(budget.palette_banks == 5 + 2);
+  REQUIRE(budget.fits());
+
+  REQUIRE_FALSE(ti::scene_budget({body}, {{"body", 10, 17}}).fits());
+  REQUIRE_FALSE(ti::scene_budget({body}, {{"body", 65}}).fits());
+  const ti::SceneBudget missing = ti::scene_budget({}, {{"nowhere"}});
+  REQUIRE(missing.missing.size() == 1);
+  REQUIRE_FALSE(missing.fits());
+}
+
+TEST_CASE("scene_budget loads identical 4bpp palettes once") {
+  ti::AssetStats cup;
+  cup.name = "cup";
+  cup.type = "sprite";
+  cup.bpp = 4;
+  cup.palette = {0x000000, 0xffffff, 0x884422};
+  ti::AssetStats saucer = cup;
+  saucer.name = "saucer";
+  ti::AssetStats plant = cup;
+  plant.name = "plant";
+  plant.palette[2] = 0x22aa44;
+
+  REQUIRE(ti::scene_budget({cup, saucer}, {{"cup"}, {"saucer"}})
+              .palette_banks == 1);
+  REQUIRE(ti::scene_budget({cup, saucer, plant},
+                           {{"cup"}, {"saucer"}, {"plant"}})
+              .palette_banks == 2);
+  REQUIRE(ti::scene_budget({cup, saucer}, {{"cup", 1, 3}, {"saucer"}})
+              .palette_banks == 4);
+}
+
+TEST_CASE("read_bmp reads the checked-in graphics") {
+  ti::Bitmap bitmap;
+  REQUIRE(ti::read_bmp(GRAPHICS_DIR "/font.bmp", bitmap));
+  REQUIRE(bitmap.width == 8);
+  REQUIRE(bitmap.height == 840);
+  REQUIRE(bitmap.bpp == 4);
+
+  // Converted to 4bpp by tools/convert_assets.py.
+  REQUIRE(ti::read_bmp(GRAPHICS_DIR "/cash.bmp", bitmap));
+  REQUIRE(bitmap.bpp == 4);
+  REQUIRE(bitmap.colors.size() == 16);
+
+  REQUIRE(ti::read_bmp(GRAPHICS_DIR "/customer_body_a.bmp", bitmap));
+  REQUIRE(bitmap.bpp == 4);
+  REQUIRE(bitmap.width == 32);
+  REQUIRE(bitmap.height == 640);
+
+  REQUIRE_FALSE(ti::read_bmp(GRAPHICS_DIR "/missing.bmp", bitmap));
+}
+
+TEST_CASE("compressed_size follows the GBA BIOS formats") {
+  const std::vector<unsigned char> zeros(200, 0);
+  // Runs of at most 130 bytes: 130 + 70.
+  REQUIRE(ti::compressed_size(zeros, "run_length") == 4 + 2 * 2);
+  // Two literals, since copies start 2 bytes back, then 11 copies of 18
+  // bytes; 13 blocks need two flag bytes. 30 bytes, padded to a word.
+  REQUIRE(ti::compressed_size(zeros, "lz77") == 32);
+
+  std::vector<unsigned char> halves(64, 1);
+  std::fill(halves.begin(), halves.begin() + 32, 2);
+  // Two 1-bit codes: a 3-node tree plus size byte, then two words of bits.
+  REQUIRE(ti::compressed_size(halves, "huffman") == 4 + 4 + 8);
+
+  std::string codec;
+  REQUIRE(ti::compressed_size(zeros, "auto", &codec) == 8);
+  REQUIRE(codec == "run_length");
+  REQUIRE(ti::compressed_size(zeros, "none", &codec) == 200);
+  REQUIRE(codec.empty());
+}
+
+TEST_CASE("analyze estimates compressed assets and what unpacking costs") {
+  ti::Bitmap blank = make_bitmap(32, 32, [](int, int) { return 0; });
+  ti::AssetDescriptor descriptor = sprite(32);
+  const ti::AssetStats raw = ti::analyze("test", blank, descriptor);
+  REQUIRE(raw.compression.empty());
+  REQUIRE(raw.rom_bytes == raw.raw_bytes);
+  REQUIRE(raw.decompress_cycles() == 0);
+
+  descriptor.compression = "run_length";
+  const ti::AssetStats packed = ti::analyze("test", blank, descriptor);
+  REQUIRE(packed.compression == "run_length");
+  REQUIRE(packed.raw_bytes == raw.raw_bytes);
+  REQUIRE(packed.rom_bytes < raw.rom_bytes);
+  REQUIRE(packed.decompress_cycles() ==
+          (packed.raw_bytes * ti::RUN_LENGTH_CYCLES_PER_KB + 1023) / 1024);
+  REQUIRE(packed.compression_supported());
+
+  // Animated sheets are read frame by frame from ROM.
+  descriptor.height = 16;
+  REQUIRE_FALSE(ti::analyze("test", blank, descriptor).compression_supported());
+}
+
+TEST_CASE("scene_budget keeps unpacking within load time and VBlank") {
+  ti::AssetStats map;
+  map.name = "map";
+  map.type = "regular_bg";
+  map.compression = "lz77";
+  map.raw_bytes = 32 * 1024;
+  ti::AssetStats prop;
+  prop.name = "prop";
+  prop.type = "sprite";
+  prop.compression = "huffman";
+  prop.raw_bytes = 1024;
+
+  const ti::SceneBudget budget = ti::scene_budget({map}, {{"map"}});
+  REQUIRE(budget.load_cycles == 32LL * ti::LZ77_CYCLES_PER_KB);
+  REQUIRE(budget.fits());
+
+  // A background may take longer than VBlank; a sprite may not.
+  const ti::SceneBudget slow = ti::scene_budget({prop}, {{"prop"}});
+  REQUIRE(slow.slow_sprites.size() == 1);
+  REQUIRE_FALSE(slow.fits());
+
+  map.raw_bytes = 128 * 1024;
+  REQUIRE_FALSE(ti::scene_budget({map}, {{"map"}}).fits());
+}
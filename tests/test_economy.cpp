@@ -0,0 +1,147 @@
+// test_economy.cpp
+// Checks the closed-form offline economy (ti_economy) against CrowdSim soaks
+// and the save helpers (ti_save) used to credit time away.
+
+#include <catch2/catch_all.hpp>
+
+#include "ti_crowd_sim.h"
+#include "ti_economy.h"
+#include "ti_save.h"
+
+namespace {
+constexpr int kFramesPerHour = ti::EconomyModel::FRAMES_PER_HOUR;
+
+ti::EconomyModel model_of(const ti::CrowdSim& crowd, int active) {
+  ti::EconomyModel model;
+  for (int i = 0; i < active; i++) {
+    model.add_customer(crowd.people().at(i).get_speed());
+  }
+  return model;
+}
+}  // namespace
+
+TEST_CASE("EconomyModel: matches a soaked crowd at every popularity level",
+          "[economy]") {
+  for (int active : {1, 2, 4, 7, 10}) {
+    ti::CrowdSim crowd;
+    for (int i = 0; i < active; i++) {
+      crowd.add_person(i % 2 == 0 ? ti::START::RIGHT : ti::START::LEFT,
+                       ti::TYPE::GREEN_SHIRT);
+    }
+    // Let the first customers reach the street loop before counting.
+    for (int frame = 0; frame < kFramesPerHour / 2; frame++) {
+      crowd.update(active);
+    }
+    int purchases = 0;
+    for (int frame = 0; frame < 3 * kFramesPerHour; frame++) {
+      purchases += crowd.update(active);
+    }
+
+    const int simulated = purchases / 3;
+    const int modelled = model_of(crowd, active).purchases_per_hour();
+    INFO(active << " customers: simulated " << simulated << "/h, modelled "
+                << modelled << "/h");
+    // Within 6%.
+    REQUIRE(modelled * 100 >= simulated * 94);
+    REQUIRE(modelled * 100 <= simulated * 106);
+  }
+}
+
+TEST_CASE("EconomyModel: the till caps purchases however busy it gets",
+          "[economy]") {
+  ti::EconomyModel model;
+  for (int i = 0; i < 64; i++) {
+    model.add_customer(0.4);
+  }
+  const int cap = kFramesPerHour / ti::EconomyModel::service_frames(0.4);
+  REQUIRE(model.purchases_per_hour() <= cap);
+  REQUIRE(model.purchases_per_hour() > cap * 9 / 10);
+}
+
+TEST_CASE("EconomyModel: earnings grow with time away, at constant cost",
+          "[economy]") {
+  ti::EconomyModel empty;
+  REQUIRE(empty.earnings(3600).cash == 0);
+
+  ti::EconomyModel model;
+  model.add_customer(0.25);
+  model.add_customer(0.35);
+  REQUIRE(model.earnings(0).customers == 0);
+  REQUIRE(model.earnings(-60).cash == 0);
+
+  const ti::Earnings hour = model.earnings(3600);
+  REQUIRE(hour.customers == model.purchases_per_hour());
+  // Every purchase pays 3 to 5, 4 on average.
+  REQUIRE(hour.cash == 4 * hour.customers);
+
+  const ti::Earnings day = model.earnings(24 * 3600);
+  REQUIRE(day.customers >= 24 * hour.customers);
+  REQUIRE(day.customers < 24 * (hour.customers + 1));
+
+  // A century away saturates instead of overflowing.
+  const ti::Earnings century = model.earnings(100LL * 365 * 24 * 3600);
+  REQUIRE(century.customers > 0);
+  REQUIRE(century.cash > 0);
+}
+
+TEST_CASE("clock_seconds: counts from the start of 2000", "[save]") {
+  REQUIRE(ti::clock_seconds(0, 1, 1, 0, 0, 0) == 0);
+  REQUIRE(ti::clock_seconds(0, 1, 1, 1, 2, 3) == 3723);
+  REQUIRE(ti::clock_seconds(0, 3, 1, 0, 0, 0) == 60LL * 86400);
+  REQUIRE(ti::clock_seconds(1, 1, 1, 0, 0, 0) == 366LL * 86400);
+  REQUIRE(ti::clock_seconds(1, 3, 1, 0, 0, 0) == (366LL + 59) * 86400);
+  // 2026-10-16, counted by hand: 26 years with 7 leap days, then 288 days.
+  REQUIRE(ti::clock_seconds(26, 10, 16, 12, 0, 0) ==
+          ((26LL * 365 + 7 + 288) * 24 + 12) * 3600);
+}
+
+TEST_CASE("SaveData: only credits time when both readings exist", "[save]") {
+  ti::SaveData save;
+  REQUIRE(save.valid());
+  REQUIRE(save.seconds_away(1000) == 0);
+
+  save.saved_at = 1000;
+  REQUIRE(save.seconds_away(4600) == 3600);
+  REQUIRE(save.seconds_away(ti::SaveData::NO_CLOCK) == 0);
+  REQUIRE(save.seconds_away(999) == 0);
+
+  save.magic = 0;
+  REQUIRE_FALSE(save.valid());
+}
+
+TEST_CASE("SaveData: long or garbage absences are capped", "[save]") {
+  ti::SaveData save;
+  save.saved_at = ti::clock_seconds(26, 10, 16, 12, 0, 0);
+  REQUIRE(save.seconds_away(ti::clock_seconds(99, 12, 31, 23, 59, 59)) ==
+          ti::SaveData::MAX_SECONDS_AWAY);
+
+  // Whatever SRAM held, the difference never overflows.
+  for (long long saved_at : {-1234567LL, -0x7fffffffffffffffLL - 1, 0LL}) {
+    save.saved_at = saved_at;
+    const long long away = save.seconds_away(0x7fffffffffffffffLL);
+    REQUIRE(away >= 0);
+    REQUIRE(away <= ti::SaveData::MAX_SECONDS_AWAY);
+  }
+  save.saved_at = 0x7fffffffffffffffLL;
+  REQUIRE(save.seconds_away(ti::clock_seconds(26, 1, 1, 0, 0, 0)) == 0);
+}
+
+TEST_CASE("add_cash saturates at what the HUD shows", "[economy]") {
+  REQUIRE(ti::add_cash(10, 5) == 15);
+  REQUIRE(ti::add_cash(ti::MAX_CASH - 5, 5) == ti::MAX_CASH);
+  REQUIRE(ti::add_cash(ti::MAX_CASH - 5, 0x7fffffff) == ti::MAX_CASH);
+  REQUIRE(ti::add_cash(0x7fffffff, 1) == ti::MAX_CASH);
+
+  // A full crowd away for as long as is credited still saves validly.
+  ti::EconomyModel model;
+  for (int i = 0; i < 10; i++) {
+    model.add_customer(0.3);
+  }
+  ti::SaveData save;
+  save.saved_at = 0;
+  save.cash = ti::add_cash(
+      ti::MAX_CASH - 1,
+      model.earnings(save.seconds_away(0x7fffffffffffffffLL)).cash);
+  REQUIRE(save.cash == ti::MAX_CASH);
+  REQUIRE(save.valid());
+}
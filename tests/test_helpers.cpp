@@ -6,7 +6,9 @@
 #include <vector>
 
 #include "cursor_helpers.h"
+#include "reference_movement.h"
 #include "ti_helpers.h"
+#include "ti_person_sim.h"
 
 TEST_CASE("get_next_step: normal movement toward target", "[helpers]") {
   bn::fixed_point from(10, 10);
@@ -39,6 +41,152 @@ TEST_CASE("get_next_step: snap when close", "[helpers]") {
   REQUIRE(result.y() == 20);
 }
 
+TEST_CASE("get_next_step: matches the trig implementation step by step",
+          "[helpers]") {
+  const bn::fixed speeds[] = {bn::fixed(0.2), bn::fixed(0.3), bn::fixed(0.4),
+                              bn::fixed(3)};
+  for (bn::fixed speed : speeds) {
+    for (int dx = -160; dx <= 160; dx += 7) {
+      for (int dy = -90; dy <= 90; dy += 5) {
+        bn::fixed_point from(bn::fixed(40) + bn::fixed(0.25), bn::fixed(-8));
+        bn::fixed_point to(from.x() + bn::fixed(dx), from.y() + bn::fixed(dy));
+        bn::fixed_point expected =
+            reference::get_next_step_trig(from, to, speed);
+        bn::fixed_point actual = ti::get_next_step(from, to, speed);
+
+        INFO("dx=" << dx << " dy=" << dy << " speed=" << speed.to_float());
+        REQUIRE(std::abs((actual.x() - expected.x()).to_float()) < 0.01f);
+        REQUIRE(std::abs((actual.y() - expected.y()).to_float()) < 0.01f);
+      }
+    }
+  }
+}
+
+TEST_CASE("get_next_step: trajectories match the trig implementation",
+          "[helpers]") {
+  const bn::fixed_point waypoints[] = {
+      bn::fixed_point(-66, 14),  bn::fixed_point(-100, 16),
+      bn::fixed_point(88, 36),   bn::fixed_point(100, 60),
+      bn::fixed_point(-140, 60), bn::fixed_point(180, 60),
+      bn::fixed_point(0, 24),    bn::fixed_point(-60, 12),
+  };
+  for (const bn::fixed_point& start : waypoints) {
+    for (const bn::fixed_point& target : waypoints) {
+      bn::fixed_point lut = start;
+      bn::fixed_point trig = start;
+      int lut_frames = 0;
+      int trig_frames = 0;
+      float max_gap = 0;
+      for (int frame = 0; frame < 3000; frame++) {
+        if (!(lut.x() == target.x() && lut.y() == target.y())) {
+          lut = ti::get_next_step(lut, target, bn::fixed(0.3));
+          lut_frames++;
+        }
+        if (!(trig.x() == target.x() && trig.y() == target.y())) {
+          trig = reference::get_next_step_trig(trig, target, bn::fixed(0.3));
+          trig_frames++;
+        }
+        // Compare while both still walk: arrival frames may differ by one,
+        // and the final snap covers up to 2 units.
+        bool lut_walking = !(lut.x() == target.x() && lut.y() == target.y());
+        bool trig_walking =
+            !(trig.x() == target.x() && trig.y() == target.y());
+        if (!lut_walking || !trig_walking) continue;
+        float gap = std::abs((lut.x() - trig.x()).to_float()) +
+                    std::abs((lut.y() - trig.y()).to_float());
+        if (gap > max_gap) max_gap = gap;
+      }
+
+      INFO("from (" << start.x().to_float() << ", " << start.y().to_float()
+                    << ") to (" << target.x().to_float() << ", "
+                    << target.y().to_float() << ")");
+      REQUIRE(std::abs(lut_frames - trig_frames) <= 1);
+      REQUIRE(max_gap < 0.5f);
+    }
+  }
+}
+
+TEST_CASE("get_step_vector: has the requested length in every direction",
+          "[helpers]") {
+  for (int dx = -50; dx <= 50; dx++) {
+    for (int dy = -50; dy <= 50; dy += 3) {
+      if (dx == 0 && dy == 0) continue;
+      bn::fixed_point step = ti::get_step_vector(
+          bn::fixed_point(0, 0), bn::fixed_point(dx, dy), bn::fixed(2));
+      float length = std::sqrt(step.x().to_float() * step.x().to_float() +
+                               step.y().to_float() * step.y().to_float());
+      INFO("dx=" << dx << " dy=" << dy);
+      REQUIRE(std::abs(length - 2.0f) < 0.005f);
+      REQUIRE((step.x().to_float() * dx + step.y().to_float() * dy) > 0);
+    }
+  }
+}
+
+TEST_CASE("count_steps_to: cached legs arrive with get_next_step",
+          "[helpers]") {
+  const bn::fixed speeds[] = {bn::fixed(0.2), bn::fixed(0.3), bn::fixed(0.4)};
+  for (bn::fixed speed : speeds) {
+    for (int dx = -240; dx <= 240; dx += 11) {
+      for (int dy = -60; dy <= 60; dy += 7) {
+        bn::fixed_point from(10, 20);
+        bn::fixed_point to(bn::fixed(10 + dx), bn::fixed(20 + dy));
+
+        int frames = 0;
+        bn::fixed_point pos = from;
+        while (!(pos.x() == to.x() && pos.y() == to.y())) {
+          pos = ti::get_next_step(pos, to, speed);
+          frames++;
+        }
+
+        bn::fixed_point step = ti::get_step_vector(from, to, speed);
+        int steps = ti::count_steps_to(from, to, step);
+        bn::fixed_point end(from.x() + step.x() * steps,
+                            from.y() + step.y() * steps);
+
+        INFO("dx=" << dx << " dy=" << dy << " speed=" << speed.to_float());
+        // +1: the snap frame. With Q12 arithmetic a walker that re-aims
+        // every frame drifts off the straight line and can arrive up to two
+        // frames earlier or later on long, slow legs.
+        REQUIRE(std::abs((steps + 1) - frames) <= 2);
+        REQUIRE(bn::abs(end.x() - to.x()) <= bn::fixed(2.5));
+        REQUIRE(bn::abs(end.y() - to.y()) <= bn::fixed(2.5));
+      }
+    }
+  }
+}
+
+TEST_CASE("count_steps_to: zero when already within snap range",
+          "[helpers]") {
+  bn::fixed_point step(1, 0);
+  REQUIRE(ti::count_steps_to(bn::fixed_point(0, 0), bn::fixed_point(2, -2),
+                             step) == 0);
+  REQUIRE(ti::count_steps_to(bn::fixed_point(0, 0), bn::fixed_point(10, 0),
+                             step) == 8);
+}
+
+TEST_CASE("is_offscreen: boxes touching the screen are visible",
+          "[helpers]") {
+  // A 32x32 sprite covers [x - 16, x + 16); the screen spans [-120, 120).
+  REQUIRE_FALSE(ti::is_offscreen(bn::fixed_point(0, 0), 16, 16));
+  REQUIRE_FALSE(ti::is_offscreen(bn::fixed_point(135, 0), 16, 16));
+  REQUIRE_FALSE(ti::is_offscreen(bn::fixed_point(-135, 0), 16, 16));
+  REQUIRE_FALSE(ti::is_offscreen(bn::fixed_point(0, 95), 16, 16));
+  REQUIRE(ti::is_offscreen(bn::fixed_point(136, 0), 16, 16));
+  REQUIRE(ti::is_offscreen(bn::fixed_point(-136, 0), 16, 16));
+  REQUIRE(ti::is_offscreen(bn::fixed_point(0, -96), 16, 16));
+}
+
+TEST_CASE("is_offscreen: customers spawn and turn around offscreen",
+          "[helpers]") {
+  ti::PersonSim left(ti::START::LEFT, ti::TYPE::GREEN_SHIRT, 0);
+  ti::PersonSim right(ti::START::RIGHT, ti::TYPE::GREEN_SHIRT, 1);
+  REQUIRE(ti::is_offscreen(left.get_position(), 16, 16));
+  REQUIRE(ti::is_offscreen(right.get_position(), 16, 16));
+  REQUIRE(ti::is_offscreen(ti::CAFE_LAYOUT.left, 16, 16));
+  REQUIRE(ti::is_offscreen(ti::CAFE_LAYOUT.right, 16, 16));
+  REQUIRE_FALSE(ti::is_offscreen(ti::CAFE_LAYOUT.door, 16, 16));
+}
+
 // Place this after the get_next_step tests.
 TEST_CASE("move_cursor: skips purchased items and respects bounds",
           "[cursor][helpers]") {
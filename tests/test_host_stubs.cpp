@@ -0,0 +1,59 @@
+// test_host_stubs.cpp
+// Pins the host bn::fixed to Butano's Q12 representation and rounding, so
+// host results keep matching the ROM.
+
+#include <catch2/catch_all.hpp>
+#include <cmath>
+
+#include "bn_fixed.h"
+#include "bn_math.h"
+
+TEST_CASE("bn::fixed: stores Q12 integers") {
+  REQUIRE(bn::fixed(1).data() == 4096);
+  REQUIRE(bn::fixed(-66).data() == -66 * 4096);
+  // Float and double constructors truncate toward zero.
+  REQUIRE(bn::fixed(0.3).data() == 1228);
+  REQUIRE(bn::fixed(-0.3).data() == -1228);
+  REQUIRE(bn::fixed::from_data(1).data() == 1);
+}
+
+TEST_CASE("bn::fixed: multiplication shifts a 64-bit product") {
+  REQUIRE((bn::fixed(0.3) * bn::fixed(0.3)).data() == (1228 * 1228) >> 12);
+  // The shift rounds toward negative infinity, not toward zero.
+  REQUIRE((bn::fixed::from_data(-1) * bn::fixed(0.5)).data() == -1);
+  REQUIRE((bn::fixed(3000) * bn::fixed(100)).data() == 300000 * 4096);
+  REQUIRE((bn::fixed(0.3) * 7).data() == 1228 * 7);
+}
+
+TEST_CASE("bn::fixed: division truncates toward zero") {
+  REQUIRE((bn::fixed(1) / bn::fixed(3)).data() == 1365);
+  REQUIRE((bn::fixed(-1) / bn::fixed(3)).data() == -1365);
+  REQUIRE((bn::fixed(7) / 2).data() == 7 * 4096 / 2);
+}
+
+TEST_CASE("bn::fixed: integer parts") {
+  bn::fixed value = bn::fixed(-2.75);
+  REQUIRE(value.integer() == -2);
+  REQUIRE(value.right_shift_integer() == -3);
+  REQUIRE(value.round_integer() == -3);
+  REQUIRE(bn::fixed(2.5).round_integer() == 3);
+}
+
+TEST_CASE("bn trig stubs: table results stay close to libm") {
+  for (int y = -100; y <= 100; y += 7) {
+    for (int x = -100; x <= 100; x += 7) {
+      if (x == 0 && y == 0) continue;
+      double expected = std::atan2(y, x) * 180 / std::acos(-1.0);
+      double actual = bn::degrees_atan2(y, x).to_double();
+      INFO("y=" << y << " x=" << x);
+      REQUIRE(std::abs(actual - expected) < 0.01);
+    }
+  }
+  for (int degrees = -360; degrees <= 360; degrees += 5) {
+    auto sin_cos = bn::degrees_sin_and_cos(bn::fixed(degrees));
+    double radians = degrees * std::acos(-1.0) / 180;
+    INFO("degrees=" << degrees);
+    REQUIRE(std::abs(sin_cos.first.to_double() - std::sin(radians)) < 0.002);
+    REQUIRE(std::abs(sin_cos.second.to_double() - std::cos(radians)) < 0.002);
+  }
+}
@@ -0,0 +1,82 @@
+// test_hud_glyphs.cpp
+// Unit tests for the dirty-tracked numeric HUD glyphs (hud_glyphs.h).
+
+#include <catch2/catch_all.hpp>
+#include <string>
+
+#include "hud_glyphs.h"
+
+namespace {
+template <int Slots>
+std::string text_of(const ti::HudGlyphs<Slots>& glyphs) {
+  std::string text;
+  for (int slot = glyphs.length() - 1; slot >= 0; --slot) {
+    text += glyphs.glyph(slot);
+  }
+  return text;
+}
+
+int count_bits(unsigned mask) {
+  int count = 0;
+  for (; mask; mask &= mask - 1) count++;
+  return count;
+}
+}  // namespace
+
+TEST_CASE("HudGlyphs: formats like \"$\" + to_string", "[hud]") {
+  ti::HudGlyphs<9> glyphs('$');
+  glyphs.set_value(535);
+  REQUIRE(text_of(glyphs) == "$535");
+  REQUIRE(glyphs.glyph(4) == ' ');
+  glyphs.set_value(0);
+  REQUIRE(text_of(glyphs) == "$0");
+  glyphs.set_value(12345678);
+  REQUIRE(text_of(glyphs) == "$12345678");
+}
+
+TEST_CASE("HudGlyphs: first value marks every slot dirty", "[hud]") {
+  ti::HudGlyphs<9> glyphs('$');
+  REQUIRE(glyphs.set_value(7) == 0x1FFu);
+}
+
+TEST_CASE("HudGlyphs: only changed characters are dirty", "[hud]") {
+  ti::HudGlyphs<9> glyphs('$');
+  glyphs.set_value(535);
+
+  REQUIRE(glyphs.set_value(535) == 0);
+  REQUIRE(glyphs.set_value(539) == 0x1u);
+  REQUIRE(glyphs.set_value(542) == 0x3u);
+  // 999 -> 1003: three digits change, a fourth appears, the "$" moves.
+  glyphs.set_value(999);
+  REQUIRE(glyphs.set_value(1003) == 0x1Fu);
+  // Shrinking hides the slot the "$" used to occupy.
+  REQUIRE(glyphs.set_value(1) == 0x1Fu);
+  REQUIRE(glyphs.glyph(2) == ' ');
+}
+
+TEST_CASE("HudGlyphs: a minute of play redraws a handful of glyphs",
+          "[hud]") {
+  // Per-frame regeneration rebuilt the whole string 3600 times a minute.
+  // Replay a busy minute: a purchase every six seconds, paying 3-5.
+  ti::HudGlyphs<9> glyphs('$');
+  glyphs.set_value(535);
+
+  int cash = 535;
+  int redraw_frames = 0;
+  int retiled_glyphs = 0;
+  for (int frame = 0; frame < 60 * 60; frame++) {
+    if (frame % 360 == 359) {
+      cash += 3 + frame % 3;
+    }
+    unsigned changed = glyphs.set_value(cash);
+    if (changed) {
+      redraw_frames++;
+      retiled_glyphs += count_bits(changed);
+    }
+  }
+
+  INFO("frames with work: " << redraw_frames
+                            << ", glyphs retiled: " << retiled_glyphs);
+  REQUIRE(redraw_frames == 10);
+  REQUIRE(retiled_glyphs <= 20);
+}
@@ -0,0 +1,191 @@
+// test_input_log.cpp
+// Unit tests for run-length keypad recording and replay, plus a host-side
+// replay of one session through the crowd simulation.
+
+#include <catch2/catch_all.hpp>
+#include <cstring>
+#include <vector>
+
+#include "ti_crowd_sim.h"
+#include "ti_input_log.h"
+
+namespace {
+using Log = ti::InputLog<64>;
+
+std::vector<unsigned short> play_all(const Log& log) {
+  std::vector<unsigned short> frames;
+  ti::InputReplay<64> replay(log);
+  unsigned short keys = 0;
+  while (replay.next(keys)) {
+    frames.push_back(keys);
+  }
+  return frames;
+}
+
+// Scripted session: press A now and then, with idle stretches in between.
+Log make_session(unsigned seed) {
+  Log log;
+  log.clear(seed);
+  for (int frame = 0; frame < 20000; frame++) {
+    log.record(frame % 1500 < 3 ? ti::KEY_A : 0);
+  }
+  return log;
+}
+
+// Everything a replay has to reproduce, compared field by field.
+struct CrowdState {
+  int purchases = 0;
+  int tick = 0;
+  int queue_size = 0;
+  std::vector<int> states;
+  std::vector<int> types;
+  std::vector<int> clips;
+  std::vector<bool> facing_left;
+  std::vector<int> x_data;
+  std::vector<int> y_data;
+
+  bool operator==(const CrowdState& other) const {
+    return purchases == other.purchases && tick == other.tick &&
+           queue_size == other.queue_size && states == other.states &&
+           types == other.types && clips == other.clips &&
+           facing_left == other.facing_left && x_data == other.x_data &&
+           y_data == other.y_data;
+  }
+};
+
+// Minimal stand-in for main(): the crowd draws from the recorded seed, and
+// every A press raises popularity by one.
+CrowdState simulate(const Log& log) {
+  ti::CrowdSim crowd(ti::OrderQueue::DEFAULT_LENGTH, log.seed());
+  for (int i = 0; i < 10; i++) {
+    crowd.add_person(i % 2 == 0 ? ti::START::RIGHT : ti::START::LEFT,
+                     ti::TYPE::GREEN_SHIRT);
+  }
+  ti::InputReplay<64> replay(log);
+  ti::FrameInput input;
+  int popularity = 1;
+  int purchases = 0;
+  unsigned short keys = 0;
+  while (replay.next(keys)) {
+    input.update(keys);
+    if (input.pressed(ti::KEY_A) && popularity < 10) {
+      popularity++;
+    }
+    if (crowd.update(popularity)) {
+      purchases++;
+    }
+  }
+
+  CrowdState state;
+  state.purchases = purchases;
+  state.tick = crowd.tick();
+  state.queue_size = crowd.order_queue().size();
+  for (const ti::PersonSim& person : crowd.people()) {
+    state.states.push_back(int(person.get_state()));
+    state.types.push_back(int(person.get_type()));
+    state.clips.push_back(int(person.get_clip()));
+    state.facing_left.push_back(person.is_facing_left());
+    state.x_data.push_back(person.get_position().x().data());
+    state.y_data.push_back(person.get_position().y().data());
+  }
+  return state;
+}
+}  // namespace
+
+TEST_CASE("InputLog: identical frames share a run") {
+  Log log;
+  log.clear(7);
+  for (int i = 0; i < 100; i++) {
+    log.record(0);
+  }
+  log.record(ti::KEY_A);
+  log.record(ti::KEY_A | ti::KEY_UP);
+  log.record(0);
+
+  REQUIRE(log.valid());
+  REQUIRE(log.seed() == 7);
+  REQUIRE(log.run_count() == 4);
+  REQUIRE(log.run(0).frames == 100);
+  REQUIRE(log.frame_count() == 103);
+}
+
+TEST_CASE("InputLog: long runs split instead of overflowing") {
+  Log log;
+  log.clear(0);
+  for (int i = 0; i < 70000; i++) {
+    log.record(ti::KEY_B);
+  }
+  REQUIRE(log.run_count() == 2);
+  REQUIRE(log.frame_count() == 70000);
+}
+
+TEST_CASE("InputLog: stops recording when full") {
+  Log log;
+  log.clear(0);
+  for (int i = 0; i < 64; i++) {
+    REQUIRE(log.record(i % 2 == 0 ? ti::KEY_A : 0));
+  }
+  REQUIRE_FALSE(log.record(ti::KEY_A));
+  REQUIRE(log.frame_count() == 64);
+}
+
+TEST_CASE("InputLog: garbage is not a valid log") {
+  Log log;
+  log.clear(0);
+  // Erased SRAM reads back as 0xff, copied in byte by byte.
+  unsigned char erased[sizeof(Log)];
+  std::memset(erased, 0xff, sizeof(erased));
+  Log garbage;
+  std::memcpy(&garbage, erased, sizeof(garbage));
+  REQUIRE(log.valid());
+  REQUIRE_FALSE(garbage.valid());
+}
+
+TEST_CASE("InputReplay: plays back every recorded frame in order") {
+  std::vector<unsigned short> recorded;
+  Log log;
+  log.clear(0);
+  for (int i = 0; i < 500; i++) {
+    unsigned short keys = (i / 7) % 3 == 0 ? ti::KEY_LEFT : 0;
+    recorded.push_back(keys);
+    log.record(keys);
+  }
+  REQUIRE(play_all(log) == recorded);
+}
+
+TEST_CASE("FrameInput: pressed only on the first held frame") {
+  ti::FrameInput input;
+  input.update(ti::KEY_A);
+  REQUIRE(input.pressed(ti::KEY_A));
+  input.update(ti::KEY_A | ti::KEY_B);
+  REQUIRE_FALSE(input.pressed(ti::KEY_A));
+  REQUIRE(input.pressed(ti::KEY_B));
+  REQUIRE(input.held(ti::KEY_A));
+  input.update(0);
+  input.update(ti::KEY_A);
+  REQUIRE(input.pressed(ti::KEY_A));
+}
+
+TEST_CASE("InputReplay: a replayed session reproduces the simulation",
+          "[sim]") {
+  Log log = make_session(0x2545f491);
+  REQUIRE(log.run_count() < 64);
+  REQUIRE(log.seed() != ti::Rng::DEFAULT_SEED);
+
+  // Round-trip through raw bytes, as the session does through SRAM.
+  Log saved;
+  std::memcpy(&saved, &log, sizeof(saved));
+  REQUIRE(saved.valid());
+  REQUIRE(saved.seed() == log.seed());
+
+  CrowdState recorded = simulate(log);
+  CrowdState replayed = simulate(saved);
+  REQUIRE(recorded.purchases > 0);
+  REQUIRE(recorded.tick == log.frame_count());
+  REQUIRE(recorded == replayed);
+
+  // Same keys under another seed: the seed has to matter for replay.
+  CrowdState reseeded = simulate(make_session(ti::Rng::DEFAULT_SEED));
+  REQUIRE(reseeded.tick == recorded.tick);
+  REQUIRE_FALSE(reseeded == recorded);
+}
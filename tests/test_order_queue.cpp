@@ -0,0 +1,58 @@
+// test_order_queue.cpp
+// Unit tests for OrderQueue, the ticket-based line at the till.
+
+#include <catch2/catch_all.hpp>
+
+#include "ti_order_queue.h"
+
+TEST_CASE("OrderQueue: tickets map to slots in joining order") {
+  ti::OrderQueue queue;
+  REQUIRE(queue.length() == 5);
+  REQUIRE(queue.empty());
+
+  int first = queue.join();
+  int second = queue.join();
+  int third = queue.join();
+  REQUIRE(queue.size() == 3);
+  REQUIRE(queue.slot(first) == 0);
+  REQUIRE(queue.slot(second) == 1);
+  REQUIRE(queue.slot(third) == 2);
+}
+
+TEST_CASE("OrderQueue: advancing moves everyone up and bumps the generation") {
+  ti::OrderQueue queue;
+  int first = queue.join();
+  int second = queue.join();
+  unsigned generation = queue.generation();
+
+  // Joining does not move anyone already in line.
+  int third = queue.join();
+  REQUIRE(queue.generation() == generation);
+
+  queue.advance();
+  REQUIRE(queue.generation() != generation);
+  REQUIRE(queue.size() == 2);
+  REQUIRE(queue.slot(second) == 0);
+  REQUIRE(queue.slot(third) == 1);
+  (void)first;
+}
+
+TEST_CASE("OrderQueue: length is configurable and clamped") {
+  ti::OrderQueue queue(7);
+  for (int i = 0; i < 6; i++) {
+    queue.join();
+  }
+  REQUIRE_FALSE(queue.full());
+  queue.join();
+  REQUIRE(queue.full());
+
+  REQUIRE(ti::OrderQueue(0).length() == 1);
+  REQUIRE(ti::OrderQueue(100).length() == ti::OrderQueue::MAX_LENGTH);
+}
+
+TEST_CASE("OrderQueue: slot positions keep the original five spots") {
+  REQUIRE(ti::OrderQueue::slot_position(0) == bn::fixed_point(-60, 12));
+  REQUIRE(ti::OrderQueue::slot_position(1) == bn::fixed_point(-55, 15));
+  REQUIRE(ti::OrderQueue::slot_position(4) == bn::fixed_point(-40, 24));
+  REQUIRE(ti::OrderQueue::slot_position(7) == bn::fixed_point(-25, 33));
+}
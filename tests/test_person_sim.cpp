@@ -0,0 +1,229 @@
+// test_person_sim.cpp
+// Headless soak tests for the customer simulation (ti_person_sim,
+// ti_crowd_sim) using Catch2, with mocks for Butano types.
+
+#include <catch2/catch_all.hpp>
+
+#include "ti_crowd_sim.h"
+#include "ti_person_sim.h"
+
+namespace {
+constexpr int kFramesPerHour = 60 * 60 * 60;
+
+void fill_crowd(ti::CrowdSim& crowd, int count) {
+  for (int i = 0; i < count; i++) {
+    crowd.add_person(i % 2 == 0 ? ti::START::RIGHT : ti::START::LEFT,
+                     ti::TYPE::GREEN_SHIRT);
+  }
+}
+}  // namespace
+
+TEST_CASE("PersonSim: starts walking in from the requested side", "[sim]") {
+  ti::PersonSim left(ti::START::LEFT, ti::TYPE::GREEN_SHIRT, 0);
+  ti::PersonSim right(ti::START::RIGHT, ti::TYPE::RED_SHIRT, 1);
+
+  REQUIRE(left.get_state() == ti::STATE::WALKING_LEFT_W_COFFEE);
+  REQUIRE(left.get_position().x() == -160);
+  REQUIRE_FALSE(left.is_facing_left());
+  REQUIRE(left.get_clip() == ti::CLIP::WALK);
+
+  REQUIRE(right.get_state() == ti::STATE::WALKING_RIGHT_W_COFFEE);
+  REQUIRE(right.get_position().x() == 160);
+  REQUIRE(right.is_facing_left());
+  REQUIRE(right.get_type() == ti::TYPE::RED_SHIRT);
+}
+
+TEST_CASE("PersonSim: stays within its memory budget", "[sim]") {
+  // Reported so size regressions show up in test logs, not just as a
+  // static_assert failure.
+  WARN("sizeof(PersonSim) = " << sizeof(ti::PersonSim) << " of "
+                              << ti::PERSON_SIM_SIZE_BUDGET << " bytes");
+  REQUIRE(sizeof(ti::PersonSim) <= ti::PERSON_SIM_SIZE_BUDGET);
+}
+
+TEST_CASE("PersonSim: a lone customer eventually buys a coffee", "[sim]") {
+  ti::CrowdSim crowd;
+  crowd.add_person(ti::START::RIGHT, ti::TYPE::GREEN_SHIRT);
+
+  bool purchased = false;
+  for (int frame = 0; frame < kFramesPerHour && !purchased; frame++) {
+    purchased = crowd.update(1);
+  }
+  REQUIRE(purchased);
+}
+
+TEST_CASE("CrowdSim: one hour of a full cafe keeps its invariants", "[sim]") {
+  ti::CrowdSim crowd;
+  fill_crowd(crowd, 10);
+
+  int purchases = 0;
+  int max_queue = 0;
+  for (int frame = 0; frame < kFramesPerHour; frame++) {
+    if (crowd.update(10)) {
+      purchases++;
+    }
+    if (crowd.order_queue().size() > max_queue) {
+      max_queue = crowd.order_queue().size();
+    }
+  }
+
+  INFO("purchases in one simulated hour: " << purchases);
+  REQUIRE(max_queue <= 5);
+  REQUIRE(purchases > 0);
+  // One till serves at most one order per ordering wait (320 frames).
+  REQUIRE(purchases <= kFramesPerHour / 320);
+}
+
+TEST_CASE("CrowdSim: free styles are exactly those nobody in play wears",
+          "[sim]") {
+  ti::CrowdSim crowd;
+  fill_crowd(crowd, 10);
+
+  for (int frame = 0; frame < kFramesPerHour / 4; frame++) {
+    // Popularity grows over time, as it does with upgrades.
+    int active = 1 + frame / 2000;
+    crowd.update(active > 10 ? 10 : active);
+    if (frame % 97 != 0) {
+      continue;
+    }
+    for (int style = 0; style < ti::CrowdSim::STYLE_COUNT; style++) {
+      bool worn = false;
+      for (int i = 0; i < active && i < 10; i++) {
+        worn |= int(crowd.people().at(i).get_type()) == style;
+      }
+      REQUIRE(crowd.styles().is_free(style) == !worn);
+    }
+  }
+}
+
+TEST_CASE("CrowdSim: a longer order queue fills past the first five spots",
+          "[sim]") {
+  ti::CrowdSim crowd(8);
+  fill_crowd(crowd, 16);
+  REQUIRE(crowd.order_queue().length() == 8);
+
+  int max_queue = 0;
+  for (int frame = 0; frame < kFramesPerHour / 4; frame++) {
+    crowd.update(16);
+    if (crowd.order_queue().size() > max_queue) {
+      max_queue = crowd.order_queue().size();
+    }
+  }
+  REQUIRE(max_queue > ti::OrderQueue::DEFAULT_LENGTH);
+  REQUIRE(max_queue <= 8);
+}
+
+TEST_CASE("CrowdSim: more customers than styles keep coming back",
+          "[sim]") {
+  ti::CrowdSim crowd;
+  fill_crowd(crowd, ti::CrowdSim::MAX_PEOPLE);
+
+  int purchases = 0;
+  for (int frame = 0; frame < kFramesPerHour; frame++) {
+    purchases += crowd.update(ti::CrowdSim::MAX_PEOPLE);
+    REQUIRE(crowd.styles().worn_count() <= ti::CrowdSim::MAX_LOOKS_IN_PLAY);
+  }
+  INFO("purchases in one simulated hour: " << purchases);
+  // Only as many looks as have palette banks, all of them in use.
+  REQUIRE(crowd.styles().worn_count() == ti::CrowdSim::MAX_LOOKS_IN_PLAY);
+  // A full till, as with ten customers, rather than a crowd stuck offscreen
+  // waiting for a free style.
+  REQUIRE(purchases > kFramesPerHour / 400);
+  REQUIRE(crowd.order_queue().size() <= 5);
+}
+
+TEST_CASE("CrowdSim: inactive customers are not simulated", "[sim]") {
+  ti::CrowdSim crowd;
+  fill_crowd(crowd, 4);
+  const bn::fixed_point parked = crowd.people().at(3).get_position();
+
+  for (int frame = 0; frame < 600; frame++) {
+    crowd.update(2);
+  }
+
+  REQUIRE(crowd.people().at(3).get_position().x() == parked.x());
+  REQUIRE(crowd.people().at(3).get_position().y() == parked.y());
+  REQUIRE_FALSE(crowd.people().at(0).get_position().x() ==
+                bn::fixed(160));
+}
+
+TEST_CASE("CrowdSim: identical crowds evolve identically", "[sim]") {
+  int purchases[2] = {0, 0};
+  bn::fixed_point last_position[2];
+  for (int run = 0; run < 2; run++) {
+    ti::CrowdSim crowd;
+    fill_crowd(crowd, 6);
+    for (int frame = 0; frame < 20000; frame++) {
+      if (crowd.update(6)) {
+        purchases[run]++;
+      }
+    }
+    last_position[run] = crowd.people().at(5).get_position();
+  }
+
+  REQUIRE(purchases[0] == purchases[1]);
+  REQUIRE(last_position[0].x() == last_position[1].x());
+  REQUIRE(last_position[0].y() == last_position[1].y());
+}
+
+TEST_CASE("CrowdSim: the shared stream is no customer's", "[sim]") {
+  constexpr unsigned seed = 0x2545f491;
+  // Customer 0 draws from stream 0: its speed is its first draw.
+  ti::Rng first = ti::Rng::stream(seed, 0);
+  ti::PersonSim person(ti::START::LEFT, ti::TYPE::GREEN_SHIRT, 0, seed);
+  REQUIRE(person.get_speed() == bn::fixed(0.3) + first.get_fixed(0.2) - 0.1);
+
+  for (int id = 0; id < ti::CrowdSim::MAX_PEOPLE; id++) {
+    ti::Rng shared = ti::Rng::stream(seed, ti::CrowdSim::SHARED_STREAM);
+    ti::Rng customer = ti::Rng::stream(seed, id);
+    int same = 0;
+    for (int draw = 0; draw < 64; draw++) {
+      if (shared.get() == customer.get()) {
+        same++;
+      }
+    }
+    REQUIRE(same == 0);
+  }
+}
+
+TEST_CASE("CrowdSim: crowds alive at once don't share loiterers", "[sim]") {
+  // Loitering is capped per crowd; a second crowd on the street must not
+  // use up the first one's slots.
+  ti::CrowdSim alone;
+  fill_crowd(alone, 6);
+  ti::CrowdSim together;
+  fill_crowd(together, 6);
+  ti::CrowdSim neighbour(ti::OrderQueue::DEFAULT_LENGTH, 1234);
+  fill_crowd(neighbour, ti::CrowdSim::MAX_PEOPLE);
+
+  int purchases[2] = {0, 0};
+  for (int frame = 0; frame < 20000; frame++) {
+    purchases[0] += alone.update(6);
+    neighbour.update(ti::CrowdSim::MAX_PEOPLE);
+    purchases[1] += together.update(6);
+  }
+
+  REQUIRE(purchases[0] == purchases[1]);
+  for (int i = 0; i < 6; i++) {
+    REQUIRE(alone.people().at(i).get_position().x() ==
+            together.people().at(i).get_position().x());
+    REQUIRE(alone.people().at(i).get_position().y() ==
+            together.people().at(i).get_position().y());
+  }
+}
+
+TEST_CASE("CrowdSim: customers joining late borrow a look in play", "[sim]") {
+  ti::CrowdSim crowd;
+  for (int i = 0; i < ti::CrowdSim::MAX_PEOPLE; i++) {
+    crowd.add_person(ti::START::LEFT,
+                     ti::TYPE(i % ti::CrowdSim::STYLE_COUNT));
+  }
+  crowd.update(ti::CrowdSim::MAX_PEOPLE);
+
+  REQUIRE(crowd.styles().worn_count() == ti::CrowdSim::MAX_LOOKS_IN_PLAY);
+  for (int i = ti::CrowdSim::MAX_LOOKS_IN_PLAY; i < ti::CrowdSim::MAX_PEOPLE;
+       i++) {
+    REQUIRE_FALSE(
+        crowd.styles().is_free(int(crowd.people().at(i).get_type())));
+  }
+}
@@ -0,0 +1,58 @@
+// test_profiler.cpp
+// Unit tests for the scoped frame-time profiler, using the host clock.
+
+#include <catch2/catch_all.hpp>
+
+#include "ti_profiler.h"
+
+TEST_CASE("ProfileStats: tracks min, average and max") {
+  ti::ProfileStats stats;
+  REQUIRE(stats.average() == 0);
+
+  stats.add(10);
+  stats.add(4);
+  stats.add(16);
+  REQUIRE(stats.samples == 3);
+  REQUIRE(stats.min == 4);
+  REQUIRE(stats.max == 16);
+  REQUIRE(stats.average() == 10);
+}
+
+TEST_CASE("Profiler::elapsed: survives one clock wrap") {
+  REQUIRE(ti::Profiler::elapsed(5, 12) == 7);
+  REQUIRE(ti::Profiler::elapsed(12, 12) == 0);
+  REQUIRE(ti::Profiler::elapsed(ti::Profiler::TICKS_PER_WRAP - 3, 2) == 5);
+}
+
+TEST_CASE("TI_PROFILE_SCOPE: records one sample per scope") {
+  ti::Profiler::reset();
+  for (int i = 0; i < 3; i++) {
+    TI_PROFILE_SCOPE(ti::PROFILE_ZONE::CROWD);
+    TI_PROFILE_SCOPE(ti::PROFILE_ZONE::PERSON);
+  }
+
+  const ti::ProfileStats& crowd = ti::Profiler::stats(ti::PROFILE_ZONE::CROWD);
+  REQUIRE(crowd.samples == 3);
+  REQUIRE(crowd.min >= 0);
+  REQUIRE(crowd.max >= crowd.min);
+  REQUIRE(ti::Profiler::stats(ti::PROFILE_ZONE::PERSON).samples == 3);
+  REQUIRE(ti::Profiler::stats(ti::PROFILE_ZONE::CORE).samples == 0);
+
+  ti::Profiler::reset();
+  REQUIRE(ti::Profiler::stats(ti::PROFILE_ZONE::CROWD).samples == 0);
+}
+
+TEST_CASE("Profiler::record: counts samples longer than a frame") {
+  ti::Profiler::reset();
+  ti::Profiler::record(ti::PROFILE_ZONE::SIM, ti::Profiler::TICKS_PER_FRAME);
+  ti::Profiler::record(ti::PROFILE_ZONE::SIM,
+                       ti::Profiler::TICKS_PER_FRAME * 8 + 1);
+
+  const ti::ProfileStats& sim = ti::Profiler::stats(ti::PROFILE_ZONE::SIM);
+  REQUIRE(sim.samples == 2);
+  REQUIRE(sim.overruns == 1);
+  REQUIRE(sim.max == ti::Profiler::TICKS_PER_FRAME * 8 + 1);
+
+  ti::Profiler::reset();
+  REQUIRE(ti::Profiler::stats(ti::PROFILE_ZONE::SIM).overruns == 0);
+}
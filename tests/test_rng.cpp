@@ -0,0 +1,96 @@
+// test_rng.cpp
+// Unit tests for Rng, the per-customer random streams.
+
+#include <catch2/catch_all.hpp>
+
+#include <set>
+#include <vector>
+
+#include "ti_rng.h"
+
+namespace {
+std::vector<unsigned> draw(ti::Rng rng, int count) {
+  std::vector<unsigned> values;
+  for (int i = 0; i < count; ++i) {
+    values.push_back(rng.get());
+  }
+  return values;
+}
+
+constexpr unsigned first_draw(unsigned seed, unsigned id) {
+  ti::Rng rng = ti::Rng::stream(seed, id);
+  return rng.get();
+}
+}  // namespace
+
+TEST_CASE("Rng: same seed and stream, same numbers") {
+  static_assert(first_draw(1, 2) == first_draw(1, 2),
+                "Streams must be usable at compile time.");
+  REQUIRE(draw(ti::Rng::stream(5, 9), 100) == draw(ti::Rng::stream(5, 9), 100));
+  REQUIRE(draw(ti::Rng(5), 100) == draw(ti::Rng::stream(5, 0), 100));
+
+  ti::Rng rng(5);
+  rng.get();
+  rng.set_seed(5);
+  REQUIRE(draw(rng, 100) == draw(ti::Rng(5), 100));
+}
+
+TEST_CASE("Rng: streams of one seed don't overlap") {
+  // Every stream's first 64 draws are distinct from every other stream's,
+  // so no customer replays another one's sequence shifted by a few frames.
+  std::set<unsigned> seen;
+  int total = 0;
+  for (unsigned id = 0; id < 32; ++id) {
+    ti::Rng rng = ti::Rng::stream(ti::Rng::DEFAULT_SEED, id);
+    for (unsigned value : draw(rng, 64)) {
+      seen.insert(value);
+      ++total;
+    }
+  }
+  REQUIRE(int(seen.size()) >= total - 1);
+}
+
+TEST_CASE("Rng: neighbouring streams are uncorrelated") {
+  // Bit agreement between stream i and i+1, draw for draw, stays near 50%.
+  for (unsigned id = 0; id < 8; ++id) {
+    std::vector<unsigned> a = draw(ti::Rng::stream(1, id), 1000);
+    std::vector<unsigned> b = draw(ti::Rng::stream(1, id + 1), 1000);
+    int agree = 0;
+    for (int i = 0; i < 1000; ++i) {
+      agree += 32 - __builtin_popcount(a[i] ^ b[i]);
+    }
+    REQUIRE(agree > 16000 * 97 / 100);
+    REQUIRE(agree < 16000 * 103 / 100);
+  }
+}
+
+TEST_CASE("Rng::get_int stays in range and spreads evenly") {
+  ti::Rng rng(42);
+  int buckets[7] = {};
+  for (int i = 0; i < 70000; ++i) {
+    int value = rng.get_int(7);
+    REQUIRE(value >= 0);
+    REQUIRE(value < 7);
+    ++buckets[value];
+  }
+  for (int count : buckets) {
+    REQUIRE(count > 9700);
+    REQUIRE(count < 10300);
+  }
+
+  REQUIRE(rng.get_int(1) == 0);
+  bn::fixed speed = rng.get_fixed(0.2);
+  REQUIRE(speed >= 0);
+  REQUIRE(speed < bn::fixed(0.2));
+}
+
+TEST_CASE("Rng::get_ints draws like repeated get_int") {
+  ti::Rng batch(3);
+  ti::Rng single(3);
+  int values[13];
+  batch.get_ints(31, values, 13);
+  for (int value : values) {
+    REQUIRE(value == single.get_int(31));
+  }
+  REQUIRE(batch.get() == single.get());
+}
@@ -0,0 +1,99 @@
+// test_style_pool.cpp
+// Unit tests for StylePool, the crowd's set of free customer styles.
+
+#include <catch2/catch_all.hpp>
+#include <algorithm>
+#include <vector>
+
+#include "bn_random.h"
+#include "ti_rng.h"
+#include "ti_style_pool.h"
+
+TEST_CASE("StylePool starts with every style free") {
+  ti::StylePool pool(14);
+  REQUIRE(pool.free_count() == 14);
+  REQUIRE(pool.is_free(0));
+  REQUIRE(pool.is_free(13));
+  REQUIRE_FALSE(pool.is_free(14));
+}
+
+TEST_CASE("A shared style stays taken until its last wearer releases it") {
+  ti::StylePool pool(14);
+  pool.acquire(3);
+  pool.acquire(3);
+  REQUIRE_FALSE(pool.is_free(3));
+  REQUIRE(pool.free_count() == 13);
+
+  pool.release(3);
+  REQUIRE_FALSE(pool.is_free(3));
+  pool.release(3);
+  REQUIRE(pool.is_free(3));
+
+  // Releasing a free style is a no-op rather than an underflow.
+  pool.release(3);
+  pool.acquire(3);
+  REQUIRE_FALSE(pool.is_free(3));
+}
+
+TEST_CASE("StylePool::pick draws like indexing the sorted free list") {
+  ti::StylePool pool(14);
+  std::vector<int> free_styles;
+  for (int style = 0; style < 14; ++style) {
+    free_styles.push_back(style);
+  }
+  for (int taken : {0, 5, 6, 13}) {
+    pool.acquire(taken);
+    free_styles.erase(std::find(free_styles.begin(), free_styles.end(), taken));
+  }
+
+  bn::random pool_rng;
+  bn::random list_rng;
+  for (int i = 0; i < 1000; ++i) {
+    int expected = free_styles.at(list_rng.get_int(free_styles.size()));
+    REQUIRE(pool.pick(pool_rng) == expected);
+  }
+}
+
+TEST_CASE("StylePool::pick only returns free styles") {
+  ti::StylePool pool(14);
+  for (int style = 0; style < 13; ++style) {
+    pool.acquire(style);
+  }
+  bn::random rng;
+  for (int i = 0; i < 50; ++i) {
+    REQUIRE(pool.pick(rng) == 13);
+  }
+  pool.acquire(13);
+  REQUIRE(pool.empty());
+}
+
+TEST_CASE("StylePool::pick draws the same from ti::Rng") {
+  ti::StylePool pool(14);
+  pool.acquire(3);
+  ti::Rng pool_rng(7);
+  ti::Rng list_rng(7);
+  for (int i = 0; i < 100; ++i) {
+    int skip = list_rng.get_int(13);
+    REQUIRE(pool.pick(pool_rng) == (skip < 3 ? skip : skip + 1));
+  }
+}
+
+TEST_CASE("StylePool caps how many distinct styles are worn") {
+  ti::StylePool pool(14, 2);
+  pool.acquire(0);
+  pool.acquire(0);
+  REQUIRE(pool.can_change(0));
+
+  pool.acquire(1);
+  REQUIRE(pool.worn_count() == 2);
+  REQUIRE_FALSE(pool.can_wear_another());
+  // A shared style would stay worn next to the new one; a lone wearer's
+  // style goes free as it changes.
+  REQUIRE_FALSE(pool.can_change(0));
+  REQUIRE(pool.can_change(1));
+
+  pool.release(0);
+  pool.release(0);
+  REQUIRE(pool.worn_count() == 1);
+  REQUIRE(pool.can_change(1));
+}
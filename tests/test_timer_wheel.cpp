@@ -0,0 +1,121 @@
+// test_timer_wheel.cpp
+// Unit tests for TimerWheel, the ambient actors' wake-up scheduler.
+
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+
+#include "ti_timer_wheel.h"
+
+namespace {
+// Advances "ticks" times and returns the tick each id last fired on.
+template <int MaxTimers, int Slots>
+std::vector<unsigned> run(ti::TimerWheel<MaxTimers, Slots>& wheel,
+                          int ticks) {
+  std::vector<unsigned> fired(MaxTimers, 0);
+  for (int tick = 0; tick < ticks; ++tick) {
+    wheel.advance([&](int id) { fired[id] = wheel.now(); });
+  }
+  return fired;
+}
+}  // namespace
+
+TEST_CASE("TimerWheel: fires each timer on the tick it is due") {
+  ti::TimerWheel<4, 8> wheel;
+  wheel.schedule(0, 1);
+  wheel.schedule(1, 5);
+  wheel.schedule(2, 8);
+  REQUIRE(wheel.pending(1));
+  REQUIRE_FALSE(wheel.pending(3));
+
+  std::vector<unsigned> fired = run(wheel, 10);
+  REQUIRE(fired[0] == 1);
+  REQUIRE(fired[1] == 5);
+  REQUIRE(fired[2] == 8);
+  REQUIRE(fired[3] == 0);
+  REQUIRE_FALSE(wheel.pending(1));
+}
+
+TEST_CASE("TimerWheel: delays longer than the wheel wait out their laps") {
+  ti::TimerWheel<3, 8> wheel;
+  wheel.schedule(0, 8);
+  wheel.schedule(1, 9);
+  wheel.schedule(2, 8 * 5 + 3);
+
+  std::vector<unsigned> fired = run(wheel, 100);
+  REQUIRE(fired[0] == 8);
+  REQUIRE(fired[1] == 9);
+  REQUIRE(fired[2] == 43);
+}
+
+TEST_CASE("TimerWheel: rescheduling replaces and cancelling drops") {
+  ti::TimerWheel<3, 8> wheel;
+  wheel.schedule(0, 3);
+  wheel.schedule(1, 3);
+  wheel.schedule(2, 3);
+  wheel.schedule(1, 6);
+  wheel.cancel(2);
+  wheel.cancel(2);
+  REQUIRE_FALSE(wheel.pending(2));
+
+  std::vector<unsigned> fired = run(wheel, 10);
+  REQUIRE(fired[0] == 3);
+  REQUIRE(fired[1] == 6);
+  REQUIRE(fired[2] == 0);
+}
+
+TEST_CASE("TimerWheel: a firing timer can schedule itself again") {
+  ti::TimerWheel<2, 16> wheel;
+  wheel.schedule(0, 31);
+  wheel.schedule(1, 16);
+
+  int fires[2] = {0, 0};
+  for (int tick = 0; tick < 31 * 10; ++tick) {
+    wheel.advance([&](int id) {
+      ++fires[id];
+      wheel.schedule(id, id == 0 ? 31 : 16);
+    });
+  }
+  REQUIRE(fires[0] == 10);
+  REQUIRE(fires[1] == 31 * 10 / 16);
+}
+
+TEST_CASE("TimerWheel: a firing timer can reschedule and cancel its siblings") {
+  ti::TimerWheel<4, 8> wheel;
+  wheel.schedule(0, 1);
+  wheel.schedule(1, 1);
+  wheel.schedule(2, 1);
+  wheel.schedule(3, 3);
+
+  // Whichever of 0..2 fires first pushes one sibling back and drops the
+  // other, while both are still in the same tick's due list.
+  int fires[4] = {0, 0, 0, 0};
+  unsigned fired_at[4] = {0, 0, 0, 0};
+  int first = -1;
+  int moved = -1;
+  int dropped = -1;
+  for (int tick = 0; tick < 10; ++tick) {
+    wheel.advance([&](int id) {
+      ++fires[id];
+      fired_at[id] = wheel.now();
+      if (first == -1 && id < 3) {
+        first = id;
+        moved = (id + 1) % 3;
+        dropped = (id + 2) % 3;
+        wheel.schedule(moved, 4);
+        wheel.cancel(dropped);
+      }
+    });
+  }
+  REQUIRE(first != -1);
+  REQUIRE(fires[first] == 1);
+  REQUIRE(fired_at[first] == 1);
+  REQUIRE(fires[moved] == 1);
+  REQUIRE(fired_at[moved] == 5);
+  REQUIRE(fires[dropped] == 0);
+  REQUIRE(fires[3] == 1);
+  REQUIRE(fired_at[3] == 3);
+  for (int id = 0; id < 4; ++id) {
+    REQUIRE_FALSE(wheel.pending(id));
+  }
+}
@@ -0,0 +1,89 @@
+"""Indexed BMP reading and writing shared by the asset tools.
+
+Only what Butano imports is supported: uncompressed 4bpp and 8bpp images
+with a colour table. Palette index 0 is transparent, as in Butano.
+"""
+
+import os
+import struct
+import sys
+
+
+def read_bmp(path):
+    """Return (width, height, rows of RGB tuples or None) of an indexed BMP.
+
+    None marks transparent pixels, i.e. palette index 0.
+    """
+    width, height, rows, palette = read_indexed(path)
+    return width, height, [[palette[index] if index else None
+                            for index in row] for row in rows]
+
+
+def read_indexed(path):
+    """Return (width, height, rows of palette indices, palette RGB tuples)."""
+    with open(path, "rb") as bmp:
+        return decode_bmp(bmp.read(), path)
+
+
+def decode_bmp(data, name):
+    """read_indexed() for BMP bytes; "name" only labels errors."""
+    offset = struct.unpack_from("<I", data, 10)[0]
+    header_size = struct.unpack_from("<I", data, 14)[0]
+    width, height = struct.unpack_from("<ii", data, 18)
+    bpp = struct.unpack_from("<H", data, 28)[0]
+    if bpp not in (4, 8):
+        sys.exit(f"{name}: {bpp}bpp, expected an indexed 4 or 8bpp image")
+    colors = struct.unpack_from("<I", data, 46)[0] or 1 << bpp
+    palette = []
+    for index in range(colors):
+        blue, green, red = data[14 + header_size + 4 * index:][:3]
+        palette.append((red, green, blue))
+
+    stride = (width * bpp + 31) // 32 * 4
+    rows = []
+    for y in range(abs(height)):
+        source_y = abs(height) - 1 - y if height > 0 else y
+        row = data[offset + source_y * stride:][:stride]
+        if bpp == 8:
+            rows.append(list(row[:width]))
+        else:
+            rows.append([row[x // 2] >> (0 if x % 2 else 4) & 15
+                         for x in range(width)])
+    return width, abs(height), rows, palette
+
+
+def encode_bmp(rows, palette):
+    """Return a bottom-up 4bpp BMP of palette indices; palette has 16 RGBs."""
+    width = len(rows[0])
+    stride = (width * 4 + 31) // 32 * 4
+    pixels = bytearray()
+    for row in reversed(rows):
+        packed = bytearray(stride)
+        for x, index in enumerate(row):
+            packed[x // 2] |= index << (0 if x % 2 else 4)
+        pixels += packed
+    table = b"".join(bytes((blue, green, red, 0))
+                     for red, green, blue in palette)
+    offset = 14 + 40 + len(table)
+    header = struct.pack("<2sIHHI", b"BM", offset + len(pixels), 0, 0, offset)
+    info = struct.pack("<IiiHHIIiiII", 40, width, len(rows), 1, 4, 0,
+                       len(pixels), 2835, 2835, len(palette), 0)
+    return header + info + table + bytes(pixels)
+
+
+def write_file(path, content, check=False):
+    """Write "content" to "path" unless it is already there.
+
+    Returns whether the file was (or, with "check", would be) changed.
+    Leaving identical files alone keeps their timestamps, so make doesn't
+    re-import assets that didn't change.
+    """
+    mode = "w" if isinstance(content, str) else "wb"
+    if os.path.exists(path):
+        with open(path, "r" if mode == "w" else "rb") as existing:
+            if existing.read() == content:
+                return False
+    if not check:
+        with open(path, mode) as output:
+            output.write(content)
+    return True
@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""Convert hand-drawn graphics to the smallest format Butano can import.
+
+Sprites and backgrounds are drawn in art/graphics as 8bpp BMPs that share
+one master palette, but almost none of them uses more than a handful of its
+colours. An 8bpp tile is twice the ROM and VRAM of a 4bpp one, so this tool
+rewrites every sprite and regular_bg with 15 opaque colours or fewer as a
+4bpp image in graphics/. Their 16-colour palettes are packed so that assets
+whose colours fit together get byte-identical palettes, which Butano then
+loads into a single palette bank.
+
+Assets are copied through unchanged when they have more colours, when their
+descriptor sets "bpp_mode" (e.g. the font, which is drawn in 4bpp on the
+first 16 colours of the text palettes so that it shares their banks) and
+when they aren't sprites or backgrounds.
+
+    convert_assets.py           # regenerate graphics/ from art/graphics/
+    convert_assets.py --check   # exit 1 if graphics/ is out of date
+    convert_assets.py --verbose # also list each asset's palette and repeats
+
+Make runs this through EXTTOOL before importing graphics. Every converted
+image is decoded again and compared with its source pixel for pixel. The
+tool also reports repeated frames and tiles: Butano already merges repeated
+background tiles, but sprite frames have to stay whole, so those are left
+for whoever draws the sheet.
+"""
+
+import argparse
+import glob
+import json
+import os
+import sys
+
+from bmp import decode_bmp, encode_bmp, read_indexed, write_file
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+ART_DIR = os.path.join(ROOT, "art", "graphics")
+GRAPHICS_DIR = os.path.join(ROOT, "graphics")
+MAX_SLOTS = 16  # 4bpp; slot 0 is transparent
+TILE = 8
+CONVERTIBLE = ("sprite", "regular_bg")
+
+
+class Asset:
+    """One art/graphics image with its descriptor."""
+
+    def __init__(self, json_path):
+        self.name = os.path.splitext(os.path.basename(json_path))[0]
+        with open(json_path) as descriptor:
+            self.descriptor_text = descriptor.read()
+        self.descriptor = json.loads(self.descriptor_text)
+        self.bmp_path = os.path.join(ART_DIR, self.name + ".bmp")
+        self.width, self.height, self.indices, self.palette = read_indexed(
+            self.bmp_path)
+        # Opaque colours in order of their index in the source palette.
+        used = sorted({index for row in self.indices for index in row} - {0})
+        self.colors = []
+        for index in used:
+            if self.palette[index] not in self.colors:
+                self.colors.append(self.palette[index])
+
+    def convertible(self):
+        return (self.descriptor.get("type") in CONVERTIBLE and
+                "bpp_mode" not in self.descriptor and
+                len(self.colors) < MAX_SLOTS)
+
+    def rgb(self):
+        """Return rows of RGB tuples, None where transparent."""
+        return [[self.palette[index] if index else None for index in row]
+                for row in self.indices]
+
+
+def load_assets():
+    assets = [Asset(path)
+              for path in sorted(glob.glob(os.path.join(ART_DIR, "*.json")))]
+    if not assets:
+        sys.exit(f"No assets in {ART_DIR}")
+    return assets
+
+
+def pack_palettes(assets):
+    """Share 15-colour palettes between assets; return [[RGB]] per palette.
+
+    Assets are placed largest first, each into the palette it grows least,
+    so the result only depends on the art.
+    """
+    palettes = []
+    assignment = {}
+    for asset in sorted(assets, key=lambda asset: (-len(asset.colors),
+                                                   asset.name)):
+        best = None
+        for number, colors in enumerate(palettes):
+            merged = colors + [color for color in asset.colors
+                               if color not in colors]
+            if len(merged) < MAX_SLOTS and (
+                    best is None or len(merged) < len(best[1])):
+                best = (number, merged)
+        if best is None:
+            palettes.append(list(asset.colors))
+            best = (len(palettes) - 1, palettes[-1])
+        palettes[best[0]] = best[1]
+        assignment[asset.name] = best[0]
+    return palettes, assignment
+
+
+def convert(asset, colors):
+    """Return the 4bpp BMP of "asset" drawn with "colors", checked."""
+    palette = [asset.palette[0]] + colors
+    palette += [(0, 0, 0)] * (MAX_SLOTS - len(palette))
+    slots = {color: slot for slot, color in enumerate(palette) if slot}
+    source = asset.rgb()
+    rows = [[slots[color] if color else 0 for color in row] for row in source]
+    data = encode_bmp(rows, palette)
+
+    width, height, decoded, decoded_palette = decode_bmp(data, asset.name)
+    if (width, height) != (asset.width, asset.height):
+        sys.exit(f"{asset.name}: converted to {width}x{height}")
+    for y, row in enumerate(decoded):
+        for x, index in enumerate(row):
+            if (decoded_palette[index] if index else None) != source[y][x]:
+                sys.exit(f"{asset.name}: converted image differs at {x},{y}")
+    return data
+
+
+def tile(rows, x, y):
+    return tuple(tuple(row[x:x + TILE]) for row in rows[y:y + TILE])
+
+
+def repeats(asset):
+    """Return a note on repeated frames or tiles, or None."""
+    rows = asset.rgb()
+    if asset.descriptor.get("type") == "sprite":
+        frame_height = asset.descriptor.get("height", asset.height)
+        frames = [tuple(map(tuple, rows[y:y + frame_height]))
+                  for y in range(0, asset.height, frame_height)]
+        repeated = len(frames) - len(set(frames))
+        if repeated:
+            return f"{repeated} of {len(frames)} frames repeat earlier ones"
+        return None
+    if asset.descriptor.get("type") == "regular_bg":
+        tiles = [tile(rows, x, y)
+                 for y in range(0, asset.height, TILE)
+                 for x in range(0, asset.width, TILE)]
+        return f"{len(set(tiles))} unique of {len(tiles)} tiles"
+    return None
+
+
+def main():
+    assets = load_assets()
+    converted = {}
+    for kind in CONVERTIBLE:
+        # Sprites and backgrounds have palette RAM of their own.
+        group = [asset for asset in assets if asset.convertible() and
+                 asset.descriptor["type"] == kind]
+        palettes, assignment = pack_palettes(group)
+        for asset in group:
+            number = assignment[asset.name]
+            converted[asset.name] = convert(asset, palettes[number])
+            if ARGS.verbose:
+                print(f"{asset.name}: 4bpp, {kind} palette {number}")
+        print(f"{len(group)} {kind} assets in 4bpp, "
+              f"{len(palettes)} palettes")
+
+    changed = []
+    for asset in assets:
+        if asset.name in converted:
+            data = converted[asset.name]
+        else:
+            with open(asset.bmp_path, "rb") as bmp:
+                data = bmp.read()
+        note = repeats(asset) if ARGS.verbose else None
+        if note:
+            print(f"{asset.name}: {note}")
+        path = os.path.join(GRAPHICS_DIR, asset.name)
+        if write_file(path + ".bmp", data, ARGS.check):
+            changed.append(asset.name + ".bmp")
+        if write_file(path + ".json", asset.descriptor_text, ARGS.check):
+            changed.append(asset.name + ".json")
+
+    for name in changed:
+        print(("out of date: " if ARGS.check else "wrote ") + name)
+    if ARGS.check and changed:
+        print("Run tools/convert_assets.py to regenerate them.")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true",
+                        help="only report graphics that need regenerating")
+    parser.add_argument("--verbose", action="store_true",
+                        help="list palettes and repeated frames per asset")
+    ARGS = parser.parse_args()
+    sys.exit(main())
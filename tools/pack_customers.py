@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+"""Pack customer walk sheets into shared 4bpp bodies plus one palette each.
+
+Every customer style is drawn as its own 32x640 8bpp sheet in art/customers
+(walk1.bmp ... walk14.bmp). Most of them share a silhouette and only differ
+in colours, so keeping a full sheet per style wastes ROM and sprite VRAM.
+
+This tool groups sheets whose transparent pixels match exactly. Within a
+group, each pixel's colours across all members become one palette slot, so
+the group is drawn once (graphics/customer_body_<letter>.bmp) and every
+member gets a palette that recolours it into that style
+(graphics/customer_look<N>.bmp, N as in walk<N>.bmp). A group holds at most
+15 opaque slots, so bodies fit in 4bpp; sheets that would overflow one start
+a new group.
+
+    pack_customers.py           # regenerate graphics/ from art/customers/
+    pack_customers.py --check   # exit 1 if graphics/ is out of date
+
+Output is verified pixel for pixel against the source sheets either way.
+"""
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+from bmp import encode_bmp, read_bmp, write_file
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+ART_DIR = os.path.join(ROOT, "art", "customers")
+GRAPHICS_DIR = os.path.join(ROOT, "graphics")
+MAX_SLOTS = 16  # 4bpp; slot 0 is transparent
+FRAME_HEIGHT = 32
+
+
+def load_sheets():
+    """Return [(number, rows)] of art/customers/walk<number>.bmp, in order."""
+    sheets = []
+    size = None
+    for path in glob.glob(os.path.join(ART_DIR, "walk*.bmp")):
+        match = re.fullmatch(r"walk(\d+)\.bmp", os.path.basename(path))
+        if not match:
+            continue
+        width, height, rows = read_bmp(path)
+        if size and size != (width, height):
+            sys.exit(f"{path}: {width}x{height}, other sheets are {size}")
+        size = (width, height)
+        sheets.append((int(match.group(1)), rows))
+    if not sheets:
+        sys.exit(f"No walk<N>.bmp sheets in {ART_DIR}")
+    return sorted(sheets)
+
+
+def silhouette(rows):
+    return tuple(tuple(color is None for color in row) for row in rows)
+
+
+def slots(members):
+    """Return the distinct opaque colour tuples of "members", in scan order."""
+    found = {}
+    for pixels in zip(*(rows for _, rows in members)):
+        for colors in zip(*pixels):
+            if colors[0] is not None:
+                found.setdefault(colors, len(found) + 1)
+    return found
+
+
+def group_sheets(sheets):
+    """Group sheets by silhouette, keeping each group within 4bpp."""
+    groups = []
+    for sheet in sheets:
+        for group in groups:
+            if (silhouette(group[0][1]) == silhouette(sheet[1]) and
+                    len(slots(group + [sheet])) < MAX_SLOTS):
+                group.append(sheet)
+                break
+        else:
+            if len(slots([sheet])) >= MAX_SLOTS:
+                sys.exit(f"walk{sheet[0]}.bmp has more than 15 colours")
+            groups.append([sheet])
+    return groups
+
+
+def pack_group(letter, members):
+    """Write one body and its members' looks; return the files it changed."""
+    found = slots(members)
+    body = [[0] * len(row) for row in members[0][1]]
+    for y, pixels in enumerate(zip(*(sheet for _, sheet in members))):
+        for x, colors in enumerate(zip(*pixels)):
+            if colors[0] is not None:
+                body[y][x] = found[colors]
+
+    changed = []
+    palettes = {}
+    for member, (number, sheet) in enumerate(members):
+        palette = [(0, 0, 0)] * MAX_SLOTS
+        for colors, slot in found.items():
+            palette[slot] = colors[member]
+        palettes[number] = palette
+        # Recolouring the body must give back the source sheet exactly.
+        for y, row in enumerate(body):
+            for x, slot in enumerate(row):
+                if (palette[slot] if slot else None) != sheet[y][x]:
+                    sys.exit(f"walk{number}.bmp differs at {x},{y}")
+        name = f"customer_look{number}"
+        path = os.path.join(GRAPHICS_DIR, name)
+        if write_file(path + ".bmp", encode_bmp([[0] * 8] * 8, palette),
+                      ARGS.check):
+            changed.append(name + ".bmp")
+        if write_file(path + ".json", '{\n  "type": "sprite_palette"\n}\n',
+                      ARGS.check):
+            changed.append(name + ".json")
+
+    name = f"customer_body_{letter}"
+    path = os.path.join(GRAPHICS_DIR, name)
+    if write_file(path + ".bmp", encode_bmp(body, palettes[members[0][0]]),
+                  ARGS.check):
+        changed.append(name + ".bmp")
+    if write_file(path + ".json", '{\n  "type": "sprite",\n'
+                  f'  "height": {FRAME_HEIGHT}\n}}\n', ARGS.check):
+        changed.append(name + ".json")
+    return changed
+
+
+def main():
+    groups = group_sheets(load_sheets())
+    changed = []
+    for index, members in enumerate(groups):
+        letter = chr(ord("a") + index)
+        changed += pack_group(letter, members)
+        looks = ", ".join(f"walk{number}" for number, _ in members)
+        print(f"customer_body_{letter}: {looks}")
+
+    for name in changed:
+        print(("out of date: " if ARGS.check else "wrote ") + name)
+    if ARGS.check and changed:
+        print("Run tools/pack_customers.py to regenerate them.")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true",
+                        help="only report graphics that need regenerating")
+    ARGS = parser.parse_args()
+    sys.exit(main())